@@ -15,6 +15,13 @@
 
 #include "async_worker_get_stats.h"
 
+#include <map>
+#include <cstring>
+
+#include "../stats/stats_binary_writer.h"
+#include "../stats/stats_member.h"
+#include "../utils/marcos.h"
+
 namespace webrtc {
 
 using namespace Napi;
@@ -22,6 +29,55 @@ using namespace Napi;
 const char kAttributeNameId[] = "id";
 const char kAttributeNameType[] = "type";
 const char kAttributeNameTimestamp[] = "timestamp";
+const char kAttributeNameStats[] = "stats";
+const char kAttributeNameDelta[] = "delta";
+const char kAttributeNameRemoved[] = "removed";
+
+// Counters for which a per-second rate is derived in delta mode
+struct RateDefinition {
+    const char* counter;
+    const char* rate;
+    double scale;
+};
+
+const RateDefinition kRateDefinitions[] = {
+    {"bytesSent", "sendBitrate", 8.0},
+    {"bytesReceived", "receiveBitrate", 8.0},
+    {"packetsSent", "packetsSentPerSecond", 1.0},
+    {"packetsReceived", "packetsReceivedPerSecond", 1.0},
+    {"packetsLost", "packetsLostPerSecond", 1.0},
+    {"framesEncoded", "framesEncodedPerSecond", 1.0},
+    {"framesDecoded", "framesDecodedPerSecond", 1.0},
+    {"framesSent", "framesSentPerSecond", 1.0},
+    {"framesReceived", "framesReceivedPerSecond", 1.0},
+};
+
+const char kRateNamePacketLossRatio[] = "packetLossRatio";
+
+template <typename T>
+std::vector<double> SequenceToDoubles(const RTCStatsMemberInterface& member)
+{
+    const auto& sequence = *member.cast_to<RTCStatsMember<std::vector<T>>>();
+    return std::vector<double>(sequence.begin(), sequence.end());
+}
+
+template <typename T>
+void MapToDoubles(const RTCStatsMemberInterface& member, std::vector<std::string>& keys, std::vector<double>& values)
+{
+    for (const auto& [key, value] : *member.cast_to<RTCStatsMember<std::map<std::string, T>>>()) {
+        keys.push_back(key);
+        values.push_back(static_cast<double>(value));
+    }
+}
+
+Napi::Object NativeToJsStats(Napi::Env env, const RTCStats& stats)
+{
+    auto jsStats = Napi::Object::New(env);
+    jsStats.Set(kAttributeNameId, Napi::String::New(env, stats.id()));
+    jsStats.Set(kAttributeNameType, Napi::String::New(env, stats.type()));
+    jsStats.Set(kAttributeNameTimestamp, Napi::Number::New(env, stats.timestamp().ms()));
+    return jsStats;
+}
 
 class NapiMap : public Napi::Object {
 public:
@@ -58,6 +114,14 @@ private:
     AsyncWorkerGetStats* asyncWorker_;
 };
 
+rtc::scoped_refptr<const RTCStatsReport>
+StatsReportHistory::Exchange(rtc::scoped_refptr<const RTCStatsReport> report)
+{
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(lastReport_, report);
+    return report;
+}
+
 AsyncWorkerGetStats* AsyncWorkerGetStats::Create(Napi::Env env, const char* resourceName)
 {
     auto asyncWorker = new AsyncWorkerGetStats(env, resourceName);
@@ -65,6 +129,15 @@ AsyncWorkerGetStats* AsyncWorkerGetStats::Create(Napi::Env env, const char* reso
     return asyncWorker;
 }
 
+AsyncWorkerGetStats* AsyncWorkerGetStats::Create(
+    Napi::Env env, const char* resourceName, std::shared_ptr<StatsReportHistory> history, bool binary)
+{
+    auto asyncWorker = Create(env, resourceName);
+    asyncWorker->history_ = std::move(history);
+    asyncWorker->binary_ = binary;
+    return asyncWorker;
+}
+
 AsyncWorkerGetStats::AsyncWorkerGetStats(Napi::Env env, const char* resourceName)
     : AsyncWorker(env, resourceName), deferred_(Napi::Promise::Deferred::New(env)), callback_()
 {
@@ -82,65 +155,283 @@ void AsyncWorkerGetStats::SetReport(const rtc::scoped_refptr<const RTCStatsRepor
 
 void AsyncWorkerGetStats::Execute()
 {
-    // do nothing
+    if (!report_) {
+        return;
+    }
+
+    if (history_) {
+        previousReport_ = history_->Exchange(report_);
+    }
+
+    if (previousReport_) {
+        CollectDelta(*previousReport_);
+    } else {
+        CollectAll();
+    }
+
+    if (binary_) {
+        Serialize();
+    } else {
+        Prepare();
+    }
 }
 
-void AsyncWorkerGetStats::OnOK()
+void AsyncWorkerGetStats::CollectAll()
 {
-    auto jsStatsReportObj = Napi::Object::New(Env());
-    auto jsStatsMap = NapiMap::Create(Env());
+    for (const auto& stats : *report_) {
+        StatsEntry entry{&stats, {}, {}};
+        for (const auto* member : stats.Members()) {
+            if (member && member->is_defined()) {
+                entry.members.push_back(member);
+            }
+        }
+        entries_.push_back(std::move(entry));
+    }
+}
 
-    if (report_) {
-        for (auto it = report_->begin(); it != report_->end(); it++) {
-            auto jsStats = Napi::Object::New(Env());
-            jsStats.Set(kAttributeNameId, Napi::String::New(Env(), it->id()));
-            jsStats.Set(kAttributeNameType, Napi::String::New(Env(), it->type()));
-            jsStats.Set(kAttributeNameTimestamp, Napi::Number::New(Env(), it->timestamp().ms()));
+void AsyncWorkerGetStats::CollectDelta(const RTCStatsReport& previous)
+{
+    for (const auto& stats : *report_) {
+        StatsEntry entry{&stats, {}, {}};
 
-            for (const auto& member : it->Members()) {
-                if (!member || !member->is_defined()) {
-                    continue;
+        auto members = stats.Members();
+        const RTCStats* prevStats = previous.Get(stats.id());
+        if (!prevStats || strcmp(prevStats->type(), stats.type()) != 0) {
+            // new stats object, deliver all members
+            for (const auto* member : members) {
+                if (member && member->is_defined()) {
+                    entry.members.push_back(member);
                 }
+            }
+            entries_.push_back(std::move(entry));
+            continue;
+        }
+
+        // same type, so the members are listed in the same order
+        auto prevMembers = prevStats->Members();
+        for (size_t i = 0; i < members.size() && i < prevMembers.size(); i++) {
+            const auto* member = members[i];
+            if (member && member->is_defined() && *member != *prevMembers[i]) {
+                entry.members.push_back(member);
+            }
+        }
 
-                switch (member->type()) {
-                    case RTCStatsMemberInterface::kBool:
-                        jsStats.Set(
-                            member->name(), Napi::Boolean::New(Env(), *member->cast_to<RTCStatsMember<bool>>()));
-                        break;
-                    case RTCStatsMemberInterface::kInt32:
-                        jsStats.Set(
-                            member->name(), Napi::Number::New(Env(), *member->cast_to<RTCStatsMember<int32_t>>()));
-                        break;
-                    case RTCStatsMemberInterface::kUint32:
-                        jsStats.Set(
-                            member->name(), Napi::Number::New(Env(), *member->cast_to<RTCStatsMember<uint32_t>>()));
-                        break;
-                    case RTCStatsMemberInterface::kInt64:
-                        jsStats.Set(
-                            member->name(), Napi::Number::New(Env(), *member->cast_to<RTCStatsMember<int64_t>>()));
-                        break;
-                    case RTCStatsMemberInterface::kUint64:
-                        jsStats.Set(
-                            member->name(), Napi::Number::New(Env(), *member->cast_to<RTCStatsMember<uint64_t>>()));
-                        break;
-                    case RTCStatsMemberInterface::kDouble:
-                        jsStats.Set(
-                            member->name(), Napi::Number::New(Env(), *member->cast_to<RTCStatsMember<double>>()));
-                        break;
-                    case RTCStatsMemberInterface::kString:
-                        jsStats.Set(member->name(), Napi::String::New(Env(), member->ValueToString()));
-                        break;
-                    default:
-                        jsStats.Set(member->name(), Napi::String::New(Env(), member->ValueToJson()));
-                        break;
+        auto elapsed = (stats.timestamp() - prevStats->timestamp()).us() / 1000000.0;
+        if (elapsed > 0) {
+            for (const auto& definition : kRateDefinitions) {
+                double value = 0;
+                double prevValue = 0;
+                if (StatsMemberToDouble(FindStatsMember(members, definition.counter), value) &&
+                    StatsMemberToDouble(FindStatsMember(prevMembers, definition.counter), prevValue))
+                {
+                    entry.rates.emplace_back(definition.rate, (value - prevValue) * definition.scale / elapsed);
                 }
             }
 
-            jsStatsMap.Set(Napi::String::New(Env(), it->id()), jsStats);
+            double lost = 0;
+            double prevLost = 0;
+            double received = 0;
+            double prevReceived = 0;
+            if (StatsMemberToDouble(FindStatsMember(members, "packetsLost"), lost) &&
+                StatsMemberToDouble(FindStatsMember(prevMembers, "packetsLost"), prevLost) &&
+                StatsMemberToDouble(FindStatsMember(members, "packetsReceived"), received) &&
+                StatsMemberToDouble(FindStatsMember(prevMembers, "packetsReceived"), prevReceived))
+            {
+                auto expected = (lost - prevLost) + (received - prevReceived);
+                entry.rates.emplace_back(kRateNamePacketLossRatio, expected > 0 ? (lost - prevLost) / expected : 0.0);
+            }
+        }
+
+        if (!entry.members.empty() || !entry.rates.empty()) {
+            entries_.push_back(std::move(entry));
+        }
+    }
+
+    for (const auto& prevStats : previous) {
+        if (!report_->Get(prevStats.id())) {
+            removedIds_.push_back(prevStats.id());
+        }
+    }
+}
+
+void AsyncWorkerGetStats::Prepare()
+{
+    for (auto& entry : entries_) {
+        entry.values.reserve(entry.members.size() + entry.rates.size());
+        for (const auto* member : entry.members) {
+            entry.values.emplace_back(member->name(), PrepareValue(*member));
+        }
+        for (const auto& rate : entry.rates) {
+            PreparedValue value{PreparedValue::Kind::kNumber};
+            value.number = rate.second;
+            entry.values.emplace_back(rate.first, std::move(value));
+        }
+    }
+}
+
+AsyncWorkerGetStats::PreparedValue AsyncWorkerGetStats::PrepareValue(const RTCStatsMemberInterface& member)
+{
+    PreparedValue value{PreparedValue::Kind::kNumber};
+
+    switch (member.type()) {
+        case RTCStatsMemberInterface::kBool:
+            value.kind = PreparedValue::Kind::kBool;
+            value.number = *member.cast_to<RTCStatsMember<bool>>() ? 1 : 0;
+            break;
+        case RTCStatsMemberInterface::kInt32:
+        case RTCStatsMemberInterface::kUint32:
+        case RTCStatsMemberInterface::kInt64:
+        case RTCStatsMemberInterface::kUint64:
+        case RTCStatsMemberInterface::kDouble:
+            StatsMemberToDouble(&member, value.number);
+            break;
+        case RTCStatsMemberInterface::kString:
+            value.kind = PreparedValue::Kind::kString;
+            value.string = member.ValueToString();
+            break;
+        case RTCStatsMemberInterface::kSequenceBool:
+            value.kind = PreparedValue::Kind::kBoolArray;
+            value.numbers = SequenceToDoubles<bool>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceInt32:
+            value.kind = PreparedValue::Kind::kNumberArray;
+            value.numbers = SequenceToDoubles<int32_t>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceUint32:
+            value.kind = PreparedValue::Kind::kNumberArray;
+            value.numbers = SequenceToDoubles<uint32_t>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceInt64:
+            value.kind = PreparedValue::Kind::kNumberArray;
+            value.numbers = SequenceToDoubles<int64_t>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceUint64:
+            value.kind = PreparedValue::Kind::kNumberArray;
+            value.numbers = SequenceToDoubles<uint64_t>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceDouble:
+            value.kind = PreparedValue::Kind::kNumberArray;
+            value.numbers = SequenceToDoubles<double>(member);
+            break;
+        case RTCStatsMemberInterface::kSequenceString:
+            value.kind = PreparedValue::Kind::kStringArray;
+            value.strings = *member.cast_to<RTCStatsMember<std::vector<std::string>>>();
+            break;
+        case RTCStatsMemberInterface::kMapStringUint64:
+            value.kind = PreparedValue::Kind::kNumberMap;
+            MapToDoubles<uint64_t>(member, value.strings, value.numbers);
+            break;
+        case RTCStatsMemberInterface::kMapStringDouble:
+            value.kind = PreparedValue::Kind::kNumberMap;
+            MapToDoubles<double>(member, value.strings, value.numbers);
+            break;
+        default:
+            // unknown type, keep the json as before
+            value.kind = PreparedValue::Kind::kString;
+            value.string = member.ValueToJson();
+            break;
+    }
+
+    return value;
+}
+
+Napi::Value AsyncWorkerGetStats::PreparedValueToJs(Napi::Env env, const PreparedValue& value)
+{
+    switch (value.kind) {
+        case PreparedValue::Kind::kBool:
+            return Napi::Boolean::New(env, value.number != 0);
+        case PreparedValue::Kind::kNumber:
+            return Napi::Number::New(env, value.number);
+        case PreparedValue::Kind::kString:
+            return Napi::String::New(env, value.string);
+        case PreparedValue::Kind::kBoolArray: {
+            auto jsArray = Napi::Array::New(env, value.numbers.size());
+            for (uint32_t i = 0; i < value.numbers.size(); i++) {
+                jsArray[i] = Napi::Boolean::New(env, value.numbers[i] != 0);
+            }
+            return jsArray;
+        }
+        case PreparedValue::Kind::kNumberArray: {
+            auto jsArray = Napi::Array::New(env, value.numbers.size());
+            for (uint32_t i = 0; i < value.numbers.size(); i++) {
+                jsArray[i] = Napi::Number::New(env, value.numbers[i]);
+            }
+            return jsArray;
+        }
+        case PreparedValue::Kind::kStringArray: {
+            auto jsArray = Napi::Array::New(env, value.strings.size());
+            for (uint32_t i = 0; i < value.strings.size(); i++) {
+                jsArray[i] = Napi::String::New(env, value.strings[i]);
+            }
+            return jsArray;
+        }
+        case PreparedValue::Kind::kNumberMap: {
+            auto jsObject = Napi::Object::New(env);
+            for (size_t i = 0; i < value.strings.size(); i++) {
+                jsObject.Set(value.strings[i], Napi::Number::New(env, value.numbers[i]));
+            }
+            return jsObject;
+        }
+        default:
+            break;
+    }
+
+    return env.Undefined();
+}
+
+void AsyncWorkerGetStats::Serialize()
+{
+    StatsBinaryWriter writer;
+    for (const auto& entry : entries_) {
+        writer.AddStats(*entry.stats, entry.members, entry.rates);
+    }
+    for (const auto& id : removedIds_) {
+        writer.AddRemoved(id);
+    }
+
+    binaryReport_ = writer.Finish(previousReport_ ? StatsBinaryWriter::kFlagDelta : 0);
+}
+
+void AsyncWorkerGetStats::OnOK()
+{
+    if (binary_ && binaryReport_.empty()) {
+        deferred_.Resolve(Napi::ArrayBuffer::New(Env(), 0));
+        return;
+    }
+
+    if (binary_) {
+        // hand the serialized report over to the ArrayBuffer without copy
+        auto data = new std::vector<uint8_t>(std::move(binaryReport_));
+        auto jsBuffer = Napi::ArrayBuffer::New(
+            Env(), data->data(), data->size(), [](Napi::Env, void*, std::vector<uint8_t>* hint) { delete hint; }, data);
+        deferred_.Resolve(jsBuffer);
+        return;
+    }
+
+    auto jsStatsReportObj = Napi::Object::New(Env());
+    auto jsStatsMap = NapiMap::Create(Env());
+
+    for (const auto& entry : entries_) {
+        auto jsStats = NativeToJsStats(Env(), *entry.stats);
+        for (const auto& [name, value] : entry.values) {
+            jsStats.Set(name, PreparedValueToJs(Env(), value));
+        }
+        jsStatsMap.Set(Napi::String::New(Env(), entry.stats->id()), jsStats);
+    }
+
+    if (previousReport_) {
+        auto jsRemoved = Napi::Array::New(Env(), removedIds_.size());
+        for (uint32_t i = 0; i < removedIds_.size(); i++) {
+            jsRemoved[i] = Napi::String::New(Env(), removedIds_[i]);
         }
+        jsStatsReportObj.Set(kAttributeNameRemoved, jsRemoved);
     }
 
-    jsStatsReportObj.Set("stats", jsStatsMap);
+    jsStatsReportObj.Set(kAttributeNameStats, jsStatsMap);
+    if (history_) {
+        // the first report of delta mode is a full one
+        jsStatsReportObj.Set(kAttributeNameDelta, Napi::Boolean::New(Env(), previousReport_ != nullptr));
+    }
     deferred_.Resolve(jsStatsReportObj);
 }
 
@@ -16,16 +16,37 @@
 #ifndef WEBRTC_ASYNC_WORKER_GET_STATS_H
 #define WEBRTC_ASYNC_WORKER_GET_STATS_H
 
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "napi.h"
 
 #include "api/peer_connection_interface.h"
 
 namespace webrtc {
 
+// Keeps the last report between the calls of getStats in delta mode
+class StatsReportHistory {
+public:
+    // Stores the new report and returns the previous one
+    rtc::scoped_refptr<const RTCStatsReport> Exchange(rtc::scoped_refptr<const RTCStatsReport> report);
+
+private:
+    std::mutex mutex_;
+    rtc::scoped_refptr<const RTCStatsReport> lastReport_;
+};
+
 class AsyncWorkerGetStats : public Napi::AsyncWorker {
 public:
     static AsyncWorkerGetStats* Create(Napi::Env env, const char* resourceName);
 
+    // With history, only changed stats and members since the previous report are delivered, plus per-second rates.
+    // With binary, the promise is resolved with an ArrayBuffer in the layout of StatsBinaryWriter.
+    static AsyncWorkerGetStats*
+    Create(Napi::Env env, const char* resourceName, std::shared_ptr<StatsReportHistory> history, bool binary);
+
     Napi::Promise GetPromise()
     {
         return deferred_.Promise();
@@ -45,9 +66,60 @@ protected:
     void OnError(const Napi::Error& e) override;
 
 private:
+    // Value of a member converted in Execute, so that OnOK only has to create the js values.
+    struct PreparedValue {
+        enum class Kind {
+            kBool,
+            kNumber,
+            kString,
+            kBoolArray,
+            kNumberArray,
+            kStringArray,
+            kNumberMap,
+        };
+
+        Kind kind;
+        // kBool, kNumber
+        double number{0};
+        // kString
+        std::string string;
+        // kBoolArray, kNumberArray, values of kNumberMap
+        std::vector<double> numbers;
+        // kStringArray, keys of kNumberMap
+        std::vector<std::string> strings;
+    };
+
+    struct StatsEntry {
+        const RTCStats* stats;
+        std::vector<const RTCStatsMemberInterface*> members;
+        std::vector<std::pair<const char*, double>> rates;
+        // members and rates, for the object format
+        std::vector<std::pair<const char*, PreparedValue>> values;
+    };
+
+    void CollectAll();
+    void CollectDelta(const RTCStatsReport& previous);
+    void Prepare();
+    void Serialize();
+
+    static PreparedValue PrepareValue(const RTCStatsMemberInterface& member);
+    static Napi::Value PreparedValueToJs(Napi::Env env, const PreparedValue& value);
+
     Napi::Promise::Deferred deferred_;
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback_;
     rtc::scoped_refptr<const RTCStatsReport> report_;
+
+    // delta mode
+    std::shared_ptr<StatsReportHistory> history_;
+    rtc::scoped_refptr<const RTCStatsReport> previousReport_;
+    std::vector<std::string> removedIds_;
+
+    // prepared in Execute
+    std::vector<StatsEntry> entries_;
+
+    // binary mode
+    bool binary_{false};
+    std::vector<uint8_t> binaryReport_;
 };
 
 } // namespace webrtc
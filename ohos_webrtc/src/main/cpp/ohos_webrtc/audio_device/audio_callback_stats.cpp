@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_callback_stats.h"
+
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+void AudioHistogram::Add(uint32_t value)
+{
+    // the number of significant bits is the bucket
+    size_t bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+    bucket = std::min(bucket, kBucketCount - 1);
+    // single writer, so a load and a store are enough
+    buckets_[bucket].store(buckets_[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> AudioHistogram::GetBuckets() const
+{
+    std::vector<uint64_t> result(kBucketCount);
+    for (size_t i = 0; i < kBucketCount; i++) {
+        result[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+const char* GlitchTypeToString(AudioGlitchType type)
+{
+    switch (type) {
+        case AudioGlitchType::UNDERRUN:
+            return "underrun";
+        case AudioGlitchType::OVERRUN:
+            return "overrun";
+        case AudioGlitchType::LATE_CALLBACK:
+            return "late-callback";
+        case AudioGlitchType::SLOW_CALLBACK:
+            return "slow-callback";
+        default:
+            return "unknown";
+    }
+}
+
+int64_t AudioCallbackStats::BeginCallback()
+{
+    return rtc::TimeMicros();
+}
+
+void AudioCallbackStats::EndCallback(int64_t beginUs, int32_t frames, int32_t sampleRate, int32_t fillMs)
+{
+    const int64_t endUs = rtc::TimeMicros();
+    const int64_t periodUs = sampleRate > 0 ? int64_t(frames) * rtc::kNumMicrosecsPerSec / sampleRate : 0;
+
+    const int64_t durationUs = endUs - beginUs;
+    duration_.Add(static_cast<uint32_t>(std::clamp<int64_t>(durationUs, 0, UINT32_MAX)));
+    if (periodUs > 0 && durationUs > periodUs) {
+        AddGlitch(AudioGlitchType::SLOW_CALLBACK, durationUs);
+    }
+
+    if (lastBeginUs_ != 0) {
+        const int64_t intervalUs = beginUs - lastBeginUs_;
+        interval_.Add(static_cast<uint32_t>(std::clamp<int64_t>(intervalUs, 0, UINT32_MAX)));
+        // a period of slack, the system may run two callbacks back to back to catch up
+        if (periodUs > 0 && intervalUs > 2 * periodUs) {
+            AddGlitch(AudioGlitchType::LATE_CALLBACK, intervalUs);
+        }
+    }
+    lastBeginUs_ = beginUs;
+
+    fill_.Add(static_cast<uint32_t>(std::max(fillMs, 0)));
+    callbackCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioCallbackStats::AddGlitch(AudioGlitchType type, int64_t value)
+{
+    RTC_DLOG(LS_WARNING) << "Audio glitch: " << GlitchTypeToString(type) << ", " << value;
+
+    const uint64_t index = glitchCount_.load(std::memory_order_relaxed);
+    auto& entry = glitches_[index % kMaxRecentGlitches];
+    // invalidate the entry while it is written
+    entry.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.timestampMs.store(rtc::TimeUTCMillis(), std::memory_order_relaxed);
+    entry.type.store(static_cast<int32_t>(type), std::memory_order_relaxed);
+    entry.value.store(value, std::memory_order_relaxed);
+    entry.sequence.store(index + 1, std::memory_order_release);
+    glitchCount_.store(index + 1, std::memory_order_release);
+}
+
+AudioCallbackStats::Snapshot AudioCallbackStats::GetSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.callbackCount = callbackCount_.load(std::memory_order_relaxed);
+    snapshot.intervalHistogram = interval_.GetBuckets();
+    snapshot.durationHistogram = duration_.GetBuckets();
+    snapshot.fillHistogram = fill_.GetBuckets();
+
+    const uint64_t count = glitchCount_.load(std::memory_order_acquire);
+    snapshot.glitchCount = count;
+    for (uint64_t index = count - std::min<uint64_t>(count, kMaxRecentGlitches); index < count; index++) {
+        const auto& entry = glitches_[index % kMaxRecentGlitches];
+        if (entry.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+
+        AudioGlitch glitch;
+        glitch.timestampMs = entry.timestampMs.load(std::memory_order_relaxed);
+        glitch.type = static_cast<AudioGlitchType>(entry.type.load(std::memory_order_relaxed));
+        glitch.value = entry.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // skip the entry if it has been overwritten in the meantime
+        if (entry.sequence.load(std::memory_order_relaxed) == index + 1) {
+            snapshot.recentGlitches.push_back(glitch);
+        }
+    }
+
+    return snapshot;
+}
+
+void AudioCallbackStats::OnStreamStart()
+{
+    lastBeginUs_ = 0;
+}
+
+} // namespace webrtc
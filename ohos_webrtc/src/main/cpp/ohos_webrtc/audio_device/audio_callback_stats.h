@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_CALLBACK_STATS_H
+#define WEBRTC_AUDIO_CALLBACK_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace webrtc {
+
+// Histogram with power of two buckets, written by one thread and read by any thread without locking.
+class AudioHistogram {
+public:
+    // bucket 0 counts 0, bucket i counts [2^(i-1), 2^i), and the last one everything above
+    static constexpr size_t kBucketCount = 20;
+
+    void Add(uint32_t value);
+    std::vector<uint64_t> GetBuckets() const;
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+};
+
+enum class AudioGlitchType {
+    // the stream ran out of samples to play
+    UNDERRUN,
+    // the stream dropped recorded samples
+    OVERRUN,
+    // the callback came more than a period after the previous one
+    LATE_CALLBACK,
+    // the callback took longer than a period, webrtc or the mixing missed its deadline
+    SLOW_CALLBACK,
+};
+
+const char* GlitchTypeToString(AudioGlitchType type);
+
+struct AudioGlitch {
+    // wall clock
+    int64_t timestampMs;
+    AudioGlitchType type;
+    // the late or slow time in us, or the number of underruns or overruns
+    int64_t value;
+};
+
+// Telemetry of the periodic callbacks of an audio stream: the interval between callbacks, their duration, the amount
+// of audio queued in the stream, and the recent glitches. Updated on the audio thread, read on any thread.
+class AudioCallbackStats {
+public:
+    static constexpr size_t kMaxRecentGlitches = 32;
+
+    struct Snapshot {
+        std::string label;
+        uint64_t callbackCount{0};
+        // in us
+        std::vector<uint64_t> intervalHistogram;
+        std::vector<uint64_t> durationHistogram;
+        // in ms
+        std::vector<uint64_t> fillHistogram;
+        uint64_t glitchCount{0};
+        // oldest first
+        std::vector<AudioGlitch> recentGlitches;
+    };
+
+    // Called on the audio thread at the start of a callback, returns the start time to pass to EndCallback.
+    int64_t BeginCallback();
+    // Called on the audio thread at the end of a callback of the frames, with the ms of audio queued in the stream.
+    void EndCallback(int64_t beginUs, int32_t frames, int32_t sampleRate, int32_t fillMs);
+    // Called on the audio thread.
+    void AddGlitch(AudioGlitchType type, int64_t value);
+
+    Snapshot GetSnapshot() const;
+
+    // Called before the stream starts. The counts are kept, only the gap since the last callback is forgotten.
+    void OnStreamStart();
+
+private:
+    struct GlitchEntry {
+        // index + 1 of the glitch in the entry, to detect entries overwritten while read
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<int64_t> timestampMs{0};
+        std::atomic<int32_t> type{0};
+        std::atomic<int64_t> value{0};
+    };
+
+    // accessed on the audio thread only
+    int64_t lastBeginUs_{0};
+
+    std::atomic<uint64_t> callbackCount_{0};
+    AudioHistogram interval_;
+    AudioHistogram duration_;
+    AudioHistogram fill_;
+
+    std::atomic<uint64_t> glitchCount_{0};
+    std::array<GlitchEntry, kMaxRecentGlitches> glitches_;
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_CALLBACK_STATS_H
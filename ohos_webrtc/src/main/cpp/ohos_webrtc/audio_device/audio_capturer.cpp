@@ -15,6 +15,7 @@
 
 #include "audio_capturer.h"
 #include "audio_common.h"
+#include "audio_sample_format.h"
 
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
@@ -125,6 +126,11 @@ int32_t AudioCapturer::InitRecording()
         OH_AudioStreamBuilder_SetLatencyMode(
             builder, UseLowLatency() ? AUDIOSTREAM_LATENCY_MODE_FAST : AUDIOSTREAM_LATENCY_MODE_NORMAL),
         NotifyError(AudioErrorType::INIT, "failed to set latency mode"), -1);
+    if (int32_t frameSize = BufferDurationToFrames(GetSampleRate(), GetBufferDuration())) {
+        OH_RESULT_CHECK(
+            OH_AudioStreamBuilder_SetFrameSizeInCallback(builder, frameSize),
+            NotifyError(AudioErrorType::INIT, "failed to set frame size"), -1);
+    }
 
     OH_AudioCapturer_Callbacks callbacks;
     callbacks.OH_AudioCapturer_OnReadData = OnReadData1;
@@ -180,6 +186,7 @@ int32_t AudioCapturer::StartRecording()
         return -1;
     }
 
+    callbackStats_.OnStreamStart();
     OH_RESULT_CHECK(
         OH_AudioCapturer_Start(capturer_), NotifyError(AudioErrorType::START_EXCEPTION, "system error"), -1);
     RTC_DLOG(LS_INFO) << "current state: " << StateToString(GetCurrentState());
@@ -220,19 +227,28 @@ std::string AudioCapturer::GetLabel() const
     return "Default";
 }
 
+const AudioCallbackStats* AudioCapturer::GetCallbackStats() const
+{
+    return &callbackStats_;
+}
+
 int32_t AudioCapturer::OnReadData(OH_AudioCapturer* stream, void* buffer, int32_t length)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " bufferLen=" << length;
 
     (void)stream;
 
+    const int64_t beginUs = callbackStats_.BeginCallback();
+
     const uint32_t overflowCount = GetOverflowCount();
     if (overflowCount_ < overflowCount) {
         RTC_LOG(LS_ERROR) << "Overflow detected: " << overflowCount;
+        callbackStats_.AddGlitch(AudioGlitchType::OVERRUN, overflowCount - overflowCount_);
         overflowCount_ = overflowCount;
     }
 
-    auto latencyMillis = EstimateLatencyMillis();
+    const int32_t frames = length / (GetChannelCount() * GetBytesPerSample(GetSampleFormat()));
+    auto latencyMillis = EstimateLatencyMillis(frames);
     RTC_DLOG(LS_VERBOSE) << "Estimate latencyMillis=" << latencyMillis;
 
     if (mute_) {
@@ -240,7 +256,11 @@ int32_t AudioCapturer::OnReadData(OH_AudioCapturer* stream, void* buffer, int32_
         std::fill(it, it + length, 0);
     }
 
-    NotifyDataReady(buffer, length, rtc::TimeMicros(), latencyMillis);
+    NotifyDataReady(
+        buffer, length, rtc::TimeMicros(), static_cast<int64_t>(latencyMillis * rtc::kNumMicrosecsPerMillisec));
+
+    // the delivery includes the processing of webrtc, so a slow callback is a deadline missed on our side
+    callbackStats_.EndCallback(beginUs, frames, GetSampleRate(), static_cast<int32_t>(latencyMillis + kHalfSec));
 
     return -1;
 }
@@ -290,11 +310,39 @@ OH_AudioStream_State AudioCapturer::GetCurrentState() const
     return state;
 }
 
-double AudioCapturer::EstimateLatencyMillis() const
+double AudioCapturer::EstimateLatencyMillis(int64_t framesInBuffer) const
 {
     RTC_DCHECK(capturer_);
 
-    return static_cast<double>(framesPerBurst_) / GetSampleRate() * rtc::kNumMillisecsPerSec;
+    // at least the duration of a buffer
+    double latencyMillis = static_cast<double>(framesPerBurst_) / GetSampleRate() * rtc::kNumMillisecsPerSec;
+
+    int64_t framePosition = 0;
+    int64_t timestamp = 0;
+    OH_AudioStream_Result result =
+        OH_AudioCapturer_GetTimestamp(capturer_, CLOCK_MONOTONIC, &framePosition, &timestamp);
+    if (result != AUDIOSTREAM_SUCCESS || timestamp <= 0) {
+        return latencyMillis;
+    }
+
+    int64_t framesRead = 0;
+    result = OH_AudioCapturer_GetFramesRead(capturer_, &framesRead);
+    if (result != AUDIOSTREAM_SUCCESS) {
+        return latencyMillis;
+    }
+    RTC_DLOG(LS_VERBOSE) << "framePosition=" << framePosition << ", timestamp=" << timestamp
+                         << ", framesRead=" << framesRead;
+
+    // the frame at framePosition was captured at timestamp, the delay is the age of the newest frame of the buffer
+    int64_t newestFrame = framesRead + framesInBuffer;
+    double captureTimeNanos =
+        timestamp + static_cast<double>(newestFrame - framePosition) * rtc::kNumNanosecsPerSec / GetSampleRate();
+    double ageMillis = (MonotonicTimeNanos() - captureTimeNanos) / rtc::kNumNanosecsPerMillisec;
+    if (ageMillis > 0) {
+        latencyMillis = ageMillis;
+    }
+
+    return latencyMillis;
 }
 
 uint32_t AudioCapturer::GetOverflowCount() const
@@ -340,12 +388,17 @@ bool AudioCapturer::CheckConfiguration(OH_AudioCapturer* capturer)
     OH_RESULT_CHECK(
         OH_AudioCapturer_GetSampleFormat(capturer, &sampleFormat),
         NotifyError(AudioErrorType::INIT, "failed to get sample format"), false);
-    if (sampleFormat != AUDIOSTREAM_SAMPLE_S16LE) {
+    if (sampleFormat != GetSampleFormat() || !IsSupportedSampleFormat(sampleFormat)) {
         RTC_LOG(LS_ERROR) << "Stream unable to use requested format";
         NotifyError(AudioErrorType::INIT, "unmatched sample format");
         return false;
     }
 
+    OH_RESULT_CHECK(
+        OH_AudioCapturer_GetFrameSizeInCallback(capturer, &framesPerBurst_),
+        NotifyError(AudioErrorType::INIT, "failed to get frame size"), false);
+    RTC_LOG(LS_INFO) << "framesPerBurst: " << framesPerBurst_;
+
     return true;
 }
 
@@ -52,6 +52,7 @@ public:
     bool Recording() const override;
 
     std::string GetLabel() const override;
+    const AudioCallbackStats* GetCallbackStats() const override;
 
 protected:
     static int32_t OnReadData1(OH_AudioCapturer* stream, void* userData, void* buffer, int32_t lenth);
@@ -67,7 +68,8 @@ protected:
 
     int32_t GetAudioSource() const;
     OH_AudioStream_State GetCurrentState() const;
-    double EstimateLatencyMillis() const;
+    // Delay from the capture of the newest frame of the buffer being read to now.
+    double EstimateLatencyMillis(int64_t framesInBuffer) const;
     uint32_t GetOverflowCount() const;
     bool CheckConfiguration(OH_AudioCapturer* capturer);
 
@@ -79,6 +81,7 @@ private:
 
     int32_t framesPerBurst_{0};
     uint32_t overflowCount_{0};
+    AudioCallbackStats callbackStats_;
 
     OH_AudioCapturer* capturer_{nullptr};
 };
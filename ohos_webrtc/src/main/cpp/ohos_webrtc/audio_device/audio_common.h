@@ -19,6 +19,7 @@
 #include <bits/alltypes.h>
 #include <cstddef>
 #include <cstdint>
+#include <ctime>
 
 #include <ohaudio/native_audiostream_base.h>
 
@@ -36,6 +37,9 @@ constexpr float kHalfSec = 0.5;
 const int kLowLatencyModeDelayEstimateInMilliseconds = 25;
 const int kHighLatencyModeDelayEstimateInMilliseconds = 75;
 
+// Native buffer duration of the low latency profile.
+constexpr int32_t kLowLatencyBufferDurationInMs = 5;
+
 #define OH_RESULT_CHECK(op, ...)                                                                                       \
     do {                                                                                                               \
         OH_AudioStream_Result result = (op);                                                                           \
@@ -45,6 +49,20 @@ const int kHighLatencyModeDelayEstimateInMilliseconds = 75;
         }                                                                                                              \
     } while (0)
 
+// The clock of the timestamps of audio streams.
+inline int64_t MonotonicTimeNanos()
+{
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Frames per callback of a native buffer of the duration, 0 to leave it to the system.
+inline int32_t BufferDurationToFrames(int32_t sampleRate, int32_t durationMs)
+{
+    return durationMs > 0 ? sampleRate * durationMs / 1000 : 0;
+}
+
 inline const char* StateToString(OH_AudioStream_State state)
 {
     switch (state) {
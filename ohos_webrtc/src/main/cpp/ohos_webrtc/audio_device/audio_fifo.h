@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_FIFO_H
+#define WEBRTC_AUDIO_FIFO_H
+
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+namespace webrtc {
+
+// Wait-free sample FIFO for a single producer thread and a single consumer thread.
+// The capacity is rounded up to a power of 2.
+template <typename T>
+class AudioFifo {
+public:
+    explicit AudioFifo(size_t capacity) : capacity_(RoundUpToPowerOf2(capacity)), buffer_(new T[capacity_]) {}
+
+    size_t Capacity() const
+    {
+        return capacity_;
+    }
+
+    // Producer only. Write as many samples as fit, and return the number of samples written.
+    size_t Write(const T* data, size_t count)
+    {
+        const size_t writePos = writePos_.load(std::memory_order_relaxed);
+        const size_t readPos = readPos_.load(std::memory_order_acquire);
+        count = std::min(count, capacity_ - (writePos - readPos));
+
+        CopyIn(writePos, data, count);
+        writePos_.store(writePos + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Consumer only. Read at most count samples, and return the number of samples read.
+    size_t Read(T* data, size_t count)
+    {
+        const size_t readPos = readPos_.load(std::memory_order_relaxed);
+        const size_t writePos = writePos_.load(std::memory_order_acquire);
+        count = std::min(count, writePos - readPos);
+
+        CopyOut(readPos, data, count);
+        readPos_.store(readPos + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Consumer only. Call f(data, count) on at most count samples in place, in up to 2 contiguous parts, then drop
+    // them. Return the number of samples consumed.
+    template <typename F>
+    size_t Consume(size_t count, F&& f)
+    {
+        const size_t readPos = readPos_.load(std::memory_order_relaxed);
+        const size_t writePos = writePos_.load(std::memory_order_acquire);
+        count = std::min(count, writePos - readPos);
+
+        const size_t offset = readPos & (capacity_ - 1);
+        const size_t firstPart = std::min(count, capacity_ - offset);
+        if (firstPart > 0) {
+            f(static_cast<const T*>(buffer_.get() + offset), firstPart);
+        }
+        if (count > firstPart) {
+            f(static_cast<const T*>(buffer_.get()), count - firstPart);
+        }
+        readPos_.store(readPos + count, std::memory_order_release);
+
+        return count;
+    }
+
+    // Consumer only. Drop everything written so far.
+    void Clear()
+    {
+        readPos_.store(writePos_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    size_t AvailableRead() const
+    {
+        return writePos_.load(std::memory_order_acquire) - readPos_.load(std::memory_order_acquire);
+    }
+
+    size_t AvailableWrite() const
+    {
+        return capacity_ - AvailableRead();
+    }
+
+private:
+    static size_t RoundUpToPowerOf2(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void CopyIn(size_t pos, const T* data, size_t count)
+    {
+        const size_t offset = pos & (capacity_ - 1);
+        const size_t firstPart = std::min(count, capacity_ - offset);
+        memcpy(buffer_.get() + offset, data, firstPart * sizeof(T));
+        memcpy(buffer_.get(), data + firstPart, (count - firstPart) * sizeof(T));
+    }
+
+    void CopyOut(size_t pos, T* data, size_t count) const
+    {
+        const size_t offset = pos & (capacity_ - 1);
+        const size_t firstPart = std::min(count, capacity_ - offset);
+        memcpy(data, buffer_.get() + offset, firstPart * sizeof(T));
+        memcpy(data + firstPart, buffer_.get(), (count - firstPart) * sizeof(T));
+    }
+
+private:
+    const size_t capacity_;
+    const std::unique_ptr<T[]> buffer_;
+
+    // positions only grow, the difference is the number of samples in the fifo
+    alignas(64) std::atomic<size_t> writePos_{0};
+    alignas(64) std::atomic<size_t> readPos_{0};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_FIFO_H
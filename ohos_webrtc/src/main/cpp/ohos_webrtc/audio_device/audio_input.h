@@ -24,6 +24,7 @@
 #include "modules/audio_device/audio_device_buffer.h"
 #include "rtc_base/copy_on_write_buffer.h"
 
+#include "audio_callback_stats.h"
 #include "audio_common.h"
 
 namespace webrtc {
@@ -34,6 +35,8 @@ struct AudioInputOptions {
     std::optional<int32_t> source;
     std::optional<int32_t> format;
     std::optional<bool> useLowLatency;
+    // duration of the native buffers in ms
+    std::optional<int32_t> bufferDuration;
 };
 
 class AudioInput {
@@ -75,6 +78,12 @@ public:
     {
         return "";
     }
+
+    // Telemetry of the callbacks delivering the samples, nullptr if not measured.
+    virtual const AudioCallbackStats* GetCallbackStats() const
+    {
+        return nullptr;
+    }
 };
 
 class AudioInputBase : public AudioInput {
@@ -122,6 +131,12 @@ public:
         return options_.useLowLatency.value_or(false);
     }
 
+    // 0 if the system decides.
+    int32_t GetBufferDuration() const
+    {
+        return options_.bufferDuration.value_or(UseLowLatency() ? kLowLatencyBufferDurationInMs : 0);
+    }
+
     int32_t SetMute(bool mute) override
     {
         mute_ = mute;
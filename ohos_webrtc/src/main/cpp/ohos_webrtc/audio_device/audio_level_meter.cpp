@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_level_meter.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+
+namespace {
+
+// voice is a level this much above the noise floor, about 10 dB
+constexpr float kVoiceToNoiseRatio = 3.0f;
+// and above about -50 dBFS
+constexpr float kMinVoiceLevel = 0.003f;
+// keeps the floor above zero in digital silence
+constexpr float kMinNoiseFloor = 0.0001f;
+// the floor follows a falling level at once, and a rising one by this ratio per second
+constexpr float kNoiseFloorRisePerSec = 0.2f;
+constexpr int32_t kVoiceHangoverMs = 300;
+
+constexpr float kFullScale = 32768.0f;
+constexpr uint64_t kLevelMax = 0xffff;
+constexpr int kPeakShift = 16;
+constexpr int kVoiceShift = 32;
+
+// Sum of the squares and largest magnitude of the samples.
+void Measure(const int16_t* src, size_t count, uint64_t* sumOfSquares, int32_t* peak)
+{
+    uint64_t sum = 0;
+    int32_t max = 0;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    int64x2_t sum2 = vdupq_n_s64(0);
+    int16x8_t max8 = vdupq_n_s16(0);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        // the square of an int16 fits in an int32, the pairwise add widens to int64
+        sum2 = vpadalq_s32(sum2, vmull_s16(vget_low_s16(s), vget_low_s16(s)));
+        sum2 = vpadalq_s32(sum2, vmull_s16(vget_high_s16(s), vget_high_s16(s)));
+        // vqabs saturates -32768 to 32767
+        max8 = vmaxq_s16(max8, vqabsq_s16(s));
+    }
+    int64_t lanes64[2];
+    vst1q_s64(lanes64, sum2);
+    sum = static_cast<uint64_t>(lanes64[0] + lanes64[1]);
+    int16_t lanes16[8];
+    vst1q_s16(lanes16, max8);
+    max = *std::max_element(lanes16, lanes16 + 8);
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum2 = zero;
+    __m128i max8 = zero;
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // a pair of squares is at most 2^31, which only fits unsigned, so widen with zeros
+        __m128i pairs = _mm_madd_epi16(s, s);
+        sum2 = _mm_add_epi64(sum2, _mm_unpacklo_epi32(pairs, zero));
+        sum2 = _mm_add_epi64(sum2, _mm_unpackhi_epi32(pairs, zero));
+        // the saturating subtraction turns -32768 into 32767
+        max8 = _mm_max_epi16(max8, _mm_max_epi16(s, _mm_subs_epi16(zero, s)));
+    }
+    uint64_t lanes64[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes64), sum2);
+    sum = lanes64[0] + lanes64[1];
+    int16_t lanes16[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes16), max8);
+    max = *std::max_element(lanes16, lanes16 + 8);
+#endif
+    for (; i < count; i++) {
+        int32_t value = src[i];
+        sum += static_cast<uint64_t>(value * value);
+        max = std::max(max, std::abs(value));
+    }
+
+    *sumOfSquares = sum;
+    *peak = max;
+}
+
+uint64_t ToFixed(float level)
+{
+    return static_cast<uint64_t>(std::min(level, 1.0f) * kLevelMax + 0.5f);
+}
+
+} // namespace
+
+void AudioLevelMeter::Process(const int16_t* samples, size_t count, int32_t sampleRate, int32_t channelCount)
+{
+    if (count == 0 || sampleRate <= 0 || channelCount <= 0) {
+        return;
+    }
+
+    uint64_t sumOfSquares = 0;
+    int32_t peakValue = 0;
+    Measure(samples, count, &sumOfSquares, &peakValue);
+
+    const float rms = std::sqrt(static_cast<float>(sumOfSquares) / count) / kFullScale;
+    const float peak = peakValue / kFullScale;
+
+    const int32_t durationMs = static_cast<int32_t>(count / channelCount * 1000 / sampleRate);
+    if (rms < noiseFloor_) {
+        noiseFloor_ = std::max(rms, kMinNoiseFloor);
+    } else {
+        noiseFloor_ = std::min(rms, noiseFloor_ * (1.0f + kNoiseFloorRisePerSec * durationMs / 1000));
+    }
+
+    if (rms > kMinVoiceLevel && rms > noiseFloor_ * kVoiceToNoiseRatio) {
+        hangoverMs_ = kVoiceHangoverMs;
+    } else {
+        hangoverMs_ = std::max(hangoverMs_ - durationMs, 0);
+    }
+
+    uint64_t level = ToFixed(rms) | (ToFixed(peak) << kPeakShift);
+    if (hangoverMs_ > 0) {
+        level |= uint64_t(1) << kVoiceShift;
+    }
+    level_.store(level, std::memory_order_relaxed);
+}
+
+AudioLevelSnapshot AudioLevelMeter::GetLevel() const
+{
+    const uint64_t level = level_.load(std::memory_order_relaxed);
+
+    AudioLevelSnapshot result;
+    result.rms = static_cast<float>(level & kLevelMax) / kLevelMax;
+    result.peak = static_cast<float>((level >> kPeakShift) & kLevelMax) / kLevelMax;
+    result.voiceActive = (level >> kVoiceShift) & 1;
+    return result;
+}
+
+void AudioLevelMeter::Reset()
+{
+    noiseFloor_ = 1.0f;
+    hangoverMs_ = 0;
+    level_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace webrtc
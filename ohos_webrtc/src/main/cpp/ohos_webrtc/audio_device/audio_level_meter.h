@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_LEVEL_METER_H
+#define WEBRTC_AUDIO_LEVEL_METER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace webrtc {
+
+struct AudioLevelSnapshot {
+    // of the last processed buffer, linear in [0, 1] of full scale
+    float rms{0};
+    float peak{0};
+    // energy based voice activity, held for a while after the voice stops
+    bool voiceActive{false};
+};
+
+// Measure the level of int16 samples on the audio thread, and publish it in a single atomic word so that any thread
+// reads a consistent snapshot without locking.
+class AudioLevelMeter {
+public:
+    // Called on the audio thread.
+    void Process(const int16_t* samples, size_t count, int32_t sampleRate, int32_t channelCount);
+
+    // Called on any thread.
+    AudioLevelSnapshot GetLevel() const;
+
+    // Called on the audio thread, or while it is not running.
+    void Reset();
+
+private:
+    // estimate of the background level, tracked on the audio thread
+    float noiseFloor_{1.0f};
+    int32_t hangoverMs_{0};
+
+    // rms and peak in 16 bits each, and the voice flag
+    std::atomic<uint64_t> level_{0};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_LEVEL_METER_H
@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_mix_kernel.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// dst[i] += src[i] * gain
+void MixSameChannels(const int16_t* src, size_t count, float gain, float* dst)
+{
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), low, gain));
+        vst1q_f32(dst + i + 4, vmlaq_n_f32(vld1q_f32(dst + i + 4), high, gain));
+    }
+#elif defined(__SSE2__)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // sign extend by interleaving with itself and shifting back
+        __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+        __m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(low, g)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(high, g)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+// dst[2i] += src[i] * gain, dst[2i + 1] += src[i] * gain
+void MixMonoToStereo(const int16_t* src, size_t frames, float gain, float* dst)
+{
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4_t s = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(src + i))), gain);
+        float32x4x2_t d = vld2q_f32(dst + 2 * i);
+        d.val[0] = vaddq_f32(d.val[0], s);
+        d.val[1] = vaddq_f32(d.val[1], s);
+        vst2q_f32(dst + 2 * i, d);
+    }
+#elif defined(__SSE2__)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= frames; i += 4) {
+        __m128i s16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m128 s = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16)), g);
+        _mm_storeu_ps(dst + 2 * i, _mm_add_ps(_mm_loadu_ps(dst + 2 * i), _mm_unpacklo_ps(s, s)));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(dst + 2 * i + 4), _mm_unpackhi_ps(s, s)));
+    }
+#endif
+    for (; i < frames; i++) {
+        float s = src[i] * gain;
+        dst[2 * i] += s;
+        dst[2 * i + 1] += s;
+    }
+}
+
+// dst[i] += (src[2i] + src[2i + 1]) / 2 * gain
+void MixStereoToMono(const int16_t* src, size_t frames, float gain, float* dst)
+{
+    const float halfGain = gain * 0.5f;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        int16x4x2_t s = vld2_s16(src + 2 * i);
+        float32x4_t sum = vcvtq_f32_s32(vaddl_s16(s.val[0], s.val[1]));
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), sum, halfGain));
+    }
+#endif
+    for (; i < frames; i++) {
+        dst[i] += (src[2 * i] + src[2 * i + 1]) * halfGain;
+    }
+}
+
+} // namespace
+
+void MixS16(const int16_t* src, size_t frames, int srcChannels, int dstChannels, float gain, float* dst)
+{
+    if (srcChannels == dstChannels) {
+        MixSameChannels(src, frames * srcChannels, gain, dst);
+    } else if (srcChannels == 1 && dstChannels == 2) {
+        MixMonoToStereo(src, frames, gain, dst);
+    } else if (srcChannels == 2 && dstChannels == 1) {
+        MixStereoToMono(src, frames, gain, dst);
+    } else {
+        RTC_DCHECK_NOTREACHED() << "Unsupported channels: " << srcChannels << " to " << dstChannels;
+    }
+}
+
+float GetPeakLevel(const float* src, size_t count)
+{
+    float peak = 0;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t peak4 = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        peak4 = vmaxq_f32(peak4, vabsq_f32(vld1q_f32(src + i)));
+    }
+    float lanes[4];
+    vst1q_f32(lanes, peak4);
+    peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#elif defined(__SSE2__)
+    // clear the sign bit for the magnitude
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 peak4 = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        peak4 = _mm_max_ps(peak4, _mm_and_ps(_mm_loadu_ps(src + i), mask));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, peak4);
+    peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    for (; i < count; i++) {
+        peak = std::max(peak, std::fabs(src[i]));
+    }
+    return peak;
+}
+
+void StoreS16(const float* src, size_t count, float gain, int16_t* dst)
+{
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= count; i += 8) {
+        // vqmovn saturates, so no clamping is needed
+        int32x4_t low = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), gain));
+        int32x4_t high = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), gain));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+    }
+#elif defined(__SSE2__)
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 minValue = _mm_set1_ps(-32768.0f);
+    const __m128 maxValue = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        // clamp first, out of range conversions give INT_MIN; cvtps rounds to nearest
+        __m128 low = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), g), minValue), maxValue);
+        __m128 high = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), g), minValue), maxValue);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high)));
+    }
+#endif
+    for (; i < count; i++) {
+        float value = src[i] * gain;
+        value = value > -32768.0f ? value : -32768.0f;
+        value = value < 32767.0f ? value : 32767.0f;
+        dst[i] = static_cast<int16_t>(value + (value < 0 ? -0.5f : 0.5f));
+    }
+}
+
+} // namespace webrtc
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_MIX_KERNEL_H
+#define WEBRTC_AUDIO_MIX_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webrtc {
+
+// Building blocks of the mixing of MixingAudioInput. Samples are mixed in a float accumulator in the int16 range,
+// then stored back to int16 once per frame. NEON and SSE2 are used when available, with a scalar fallback. The inputs
+// at the mix rate are mixed straight out of their fifo, the others are resampled to int16 by PushResampler first.
+
+// Add frames of interleaved int16 samples multiplied by gain to the accumulator. Mono is duplicated to stereo, and
+// stereo is averaged to mono.
+void MixS16(const int16_t* src, size_t frames, int srcChannels, int dstChannels, float gain, float* dst);
+
+// Largest magnitude in the accumulator.
+float GetPeakLevel(const float* src, size_t count);
+
+// Multiply by gain, round and saturate to int16.
+void StoreS16(const float* src, size_t count, float gain, int16_t* dst);
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_MIX_KERNEL_H
@@ -21,7 +21,9 @@
 #include "absl/types/optional.h"
 #include "modules/audio_device/include/audio_device.h"
 
+#include "audio_callback_stats.h"
 #include "audio_common.h"
+#include "audio_level_meter.h"
 
 namespace webrtc {
 
@@ -32,6 +34,8 @@ struct AudioOutputOptions {
     std::optional<int32_t> channelCount;
     std::optional<int32_t> usage;
     std::optional<bool> useLowLatency;
+    // duration of the native buffers in ms
+    std::optional<int32_t> bufferDuration;
 };
 
 class AudioOutput {
@@ -66,6 +70,18 @@ public:
         return absl::nullopt;
     }
 
+    // Level of the samples last played.
+    virtual AudioLevelSnapshot GetLevel() const
+    {
+        return {};
+    }
+
+    // Telemetry of the callbacks requesting the samples, nullptr if not measured.
+    virtual const AudioCallbackStats* GetCallbackStats() const
+    {
+        return nullptr;
+    }
+
     virtual void RegisterObserver(Observer* obs) = 0;
     virtual void UnregisterObserver(Observer* obs) = 0;
 
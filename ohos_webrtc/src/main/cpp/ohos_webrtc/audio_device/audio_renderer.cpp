@@ -17,6 +17,7 @@
 #include "audio_common.h"
 
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "modules/audio_device/audio_device_buffer.h"
 #include "system_wrappers/include/field_trial.h"
 
@@ -154,6 +155,11 @@ int32_t AudioRenderer::InitPlayout()
         OH_AudioStreamBuilder_SetLatencyMode(
             builder, UseLowLatency() ? AUDIOSTREAM_LATENCY_MODE_FAST : AUDIOSTREAM_LATENCY_MODE_NORMAL),
         NotifyError(AudioErrorType::INIT, "failed to set latency mode"), -1);
+    if (int32_t frameSize = BufferDurationToFrames(GetSampleRate(), GetBufferDuration())) {
+        OH_RESULT_CHECK(
+            OH_AudioStreamBuilder_SetFrameSizeInCallback(builder, frameSize),
+            NotifyError(AudioErrorType::INIT, "failed to set frame size"), -1);
+    }
 
     OH_AudioRenderer_Callbacks callbacks;
     callbacks.OH_AudioRenderer_OnWriteData = OnWriteData1;
@@ -218,6 +224,7 @@ int32_t AudioRenderer::StartPlayout()
         return -1;
     }
 
+    callbackStats_.OnStreamStart();
     OH_RESULT_CHECK(
         OH_AudioRenderer_Start(renderer_), NotifyError(AudioErrorType::START_EXCEPTION, "System error"), -1);
     RTC_DLOG(LS_VERBOSE) << "Current state: " << StateToString(GetCurrentState());
@@ -241,6 +248,7 @@ int32_t AudioRenderer::StopPlayout()
 
     OH_RESULT_CHECK(OH_AudioRenderer_Stop(renderer_), -1);
     playing_ = false;
+    levelMeter_.Reset();
 
     NotifyStateChange(AudioStateType::STOP);
 
@@ -272,10 +280,15 @@ int32_t AudioRenderer::PlayoutDelay(uint16_t* delayMs) const
         return 0;
     }
 
-    RTC_DLOG(LS_VERBOSE) << "delayMs=" << *delayMs;
+    int32_t measuredDelayMs = playoutDelayMs_.load(std::memory_order_relaxed);
+    if (playing_ && measuredDelayMs > 0) {
+        *delayMs = static_cast<uint16_t>(measuredDelayMs);
+        return 0;
+    }
 
     // Best guess we can do is to use half of the estimated total delay.
-    *delayMs = kHighLatencyModeDelayEstimateInMilliseconds / halfDen;
+    *delayMs = (UseLowLatency() ? kLowLatencyModeDelayEstimateInMilliseconds
+                                : kHighLatencyModeDelayEstimateInMilliseconds) / halfDen;
     RTC_DCHECK_GT(*delayMs, 0);
 
     return 0;
@@ -288,6 +301,35 @@ int AudioRenderer::GetPlayoutUnderrunCount()
     return 0;
 }
 
+AudioLevelSnapshot AudioRenderer::GetLevel() const
+{
+    return levelMeter_.GetLevel();
+}
+
+absl::optional<AudioDeviceModule::Stats> AudioRenderer::GetStats() const
+{
+    const double sampleRate = GetSampleRate();
+    const uint64_t playedFrames = playedFrames_.load(std::memory_order_relaxed);
+    const uint64_t underrunCount = underrunCount_.load(std::memory_order_relaxed);
+
+    AudioDeviceModule::Stats stats;
+    stats.total_samples_count = playedFrames;
+    stats.total_samples_duration_s = playedFrames / sampleRate;
+    // the delay of each sample summed up, as webrtc defines it
+    stats.total_playout_delay_s =
+        static_cast<double>(playoutDelayFrameUs_.load(std::memory_order_relaxed)) / rtc::kNumMicrosecsPerSec;
+    // the system does not tell how many samples were missing, count a callback worth of samples per underrun
+    stats.synthesized_samples_events = underrunCount;
+    stats.synthesized_samples_duration_s =
+        underrunCount * framesPerCallback_.load(std::memory_order_relaxed) / sampleRate;
+    return stats;
+}
+
+const AudioCallbackStats* AudioRenderer::GetCallbackStats() const
+{
+    return &callbackStats_;
+}
+
 void AudioRenderer::RegisterObserver(Observer* obs)
 {
     if (!obs) {
@@ -323,6 +365,11 @@ bool AudioRenderer::UseLowLatency() const
     return options_.useLowLatency.value_or(false);
 }
 
+int32_t AudioRenderer::GetBufferDuration() const
+{
+    return options_.bufferDuration.value_or(UseLowLatency() ? kLowLatencyBufferDurationInMs : 0);
+}
+
 int32_t AudioRenderer::SetMute(bool mute)
 {
     RTC_LOG(LS_INFO) << __FUNCTION__;
@@ -338,14 +385,19 @@ int32_t AudioRenderer::OnWriteData(OH_AudioRenderer* renderer, void* buffer, int
     (void)renderer;
     RTC_DCHECK_RUNS_SERIALIZED(&dataRaceChecker_);
 
+    const int64_t beginUs = callbackStats_.BeginCallback();
+
     const uint32_t underflowCount = GetUnderflowCount();
     if (underflowCount_ < underflowCount) {
         RTC_LOG(LS_ERROR) << "Underflow detected: " << underflowCount;
+        callbackStats_.AddGlitch(AudioGlitchType::UNDERRUN, underflowCount - underflowCount_);
+        underrunCount_.fetch_add(underflowCount - underflowCount_, std::memory_order_relaxed);
         underflowCount_ = underflowCount;
     }
 
     auto latencyMillis = EstimateLatencyMillis();
     RTC_DLOG(LS_VERBOSE) << "Estimate latencyMillis=" << latencyMillis;
+    playoutDelayMs_.store(static_cast<int32_t>(latencyMillis + kHalfSec), std::memory_order_relaxed);
 
     fineAudioBuffer_->GetPlayoutData(
         rtc::MakeArrayView(static_cast<int16_t*>(buffer), length / sizeof(int16_t)),
@@ -356,6 +408,19 @@ int32_t AudioRenderer::OnWriteData(OH_AudioRenderer* renderer, void* buffer, int
         std::fill(it, it + length, 0);
     }
 
+    levelMeter_.Process(static_cast<int16_t*>(buffer), length / sizeof(int16_t), GetSampleRate(), GetChannelCount());
+
+    const int32_t frames = length / (sizeof(int16_t) * GetChannelCount());
+    const int32_t delayMs = static_cast<int32_t>(latencyMillis + kHalfSec);
+    framesPerCallback_.store(frames, std::memory_order_relaxed);
+    playedFrames_.fetch_add(frames, std::memory_order_relaxed);
+    playoutDelayFrameUs_.fetch_add(
+        static_cast<uint64_t>(frames) * delayMs * rtc::kNumMicrosecsPerMillisec, std::memory_order_relaxed);
+
+    // measured from the start of the callback, so the duration includes FineAudioBuffer pulling the samples from webrtc,
+    // and a slow callback is a deadline missed on our side rather than by the system
+    callbackStats_.EndCallback(beginUs, frames, GetSampleRate(), delayMs);
+
     return 0;
 }
 
@@ -433,8 +498,13 @@ double AudioRenderer::EstimateLatencyMillis() const
     }
     RTC_DLOG(LS_VERBOSE) << "framesWritten=" << framesWritten;
 
+    // the frames written but not played yet, minus the time the frame at framePosition has been playing
     int64_t frameIndexDelta = framesWritten - framePosition;
     latencyMillis = static_cast<double>(frameIndexDelta * rtc::kNumMillisecsPerSec) / GetSampleRate();
+    if (timestamp > 0) {
+        double ageMillis = static_cast<double>(MonotonicTimeNanos() - timestamp) / rtc::kNumNanosecsPerMillisec;
+        latencyMillis = std::max(0.0, latencyMillis - std::max(0.0, ageMillis));
+    }
 
     return latencyMillis;
 }
@@ -55,6 +55,9 @@ public:
     int32_t SetMute(bool mute) override;
     int32_t PlayoutDelay(uint16_t* delayMs) const override;
     int GetPlayoutUnderrunCount() override;
+    AudioLevelSnapshot GetLevel() const override;
+    absl::optional<AudioDeviceModule::Stats> GetStats() const override;
+    const AudioCallbackStats* GetCallbackStats() const override;
 
     void RegisterObserver(Observer* obs) override;
     void UnregisterObserver(Observer* obs) override;
@@ -79,6 +82,8 @@ protected:
     void OnDeviceChangeCallback(OH_AudioRenderer* renderer, OH_AudioStream_DeviceChangeReason reason);
 
     int32_t GetUsage() const;
+    // 0 if the system decides.
+    int32_t GetBufferDuration() const;
     OH_AudioStream_State GetCurrentState() const;
     double EstimateLatencyMillis() const;
     uint32_t GetUnderflowCount() const;
@@ -98,9 +103,19 @@ private:
     std::atomic<bool> mute_{false};
 
     bool initialized_{false};
-    bool playing_{false};
+    // read by Playing() and PlayoutDelay() from the capture thread
+    std::atomic<bool> playing_{false};
 
     uint32_t underflowCount_{0};
+    AudioCallbackStats callbackStats_;
+    // for GetStats, updated on the render thread
+    std::atomic<uint64_t> playedFrames_{0};
+    std::atomic<uint64_t> playoutDelayFrameUs_{0};
+    std::atomic<uint64_t> underrunCount_{0};
+    std::atomic<int32_t> framesPerCallback_{0};
+    // measured on the render thread
+    std::atomic<int32_t> playoutDelayMs_{0};
+    AudioLevelMeter levelMeter_;
 
     std::unique_ptr<FineAudioBuffer> fineAudioBuffer_;
 
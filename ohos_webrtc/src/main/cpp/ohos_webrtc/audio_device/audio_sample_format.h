@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_SAMPLE_FORMAT_H
+#define WEBRTC_AUDIO_SAMPLE_FORMAT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "audio_common.h"
+
+namespace webrtc {
+
+// Bytes of one sample, or 0 if the format is not supported by the capture pipeline.
+inline size_t GetBytesPerSample(int32_t format)
+{
+    switch (format) {
+        case AUDIOSTREAM_SAMPLE_S16LE:
+            return sizeof(int16_t);
+        case AUDIOSTREAM_SAMPLE_S32LE:
+            return sizeof(int32_t);
+        case AUDIOSTREAM_SAMPLE_F32LE:
+            return sizeof(float);
+        default:
+            return 0;
+    }
+}
+
+inline bool IsSupportedSampleFormat(int32_t format)
+{
+    return GetBytesPerSample(format) != 0;
+}
+
+// Keep the upper 16 bits.
+inline void ConvertS32ToS16(const int32_t* src, size_t count, int16_t* dst)
+{
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x4_t low = vshrn_n_s32(vld1q_s32(src + i), 16);
+        int16x4_t high = vshrn_n_s32(vld1q_s32(src + i + 4), 16);
+        vst1q_s16(dst + i, vcombine_s16(low, high));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = static_cast<int16_t>(src[i] >> 16);
+    }
+}
+
+// Scale [-1, 1] to the int16 range, round half to even and saturate, NaN converts to 0. The scalar loop matches the
+// vector one, so all the samples of a buffer convert the same way.
+inline void ConvertF32ToS16(const float* src, size_t count, int16_t* dst)
+{
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= count; i += 8) {
+        // vqmovn saturates, so no clamping is needed
+        int32x4_t low = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0f));
+        int32x4_t high = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+    }
+#endif
+    for (; i < count; i++) {
+        float value = src[i] * 32768.0f;
+        // like vcvtnq: NaN to 0, and nearbyint rounds half to even in the default rounding mode
+        value = value == value ? value : 0.0f;
+        value = std::min(std::max(value, -32768.0f), 32767.0f);
+        dst[i] = static_cast<int16_t>(std::nearbyint(value));
+    }
+}
+
+// Convert count samples of the format to int16, return false if the format is not supported.
+inline bool ConvertToS16(int32_t format, const void* src, size_t count, int16_t* dst)
+{
+    switch (format) {
+        case AUDIOSTREAM_SAMPLE_S16LE:
+            std::copy_n(static_cast<const int16_t*>(src), count, dst);
+            return true;
+        case AUDIOSTREAM_SAMPLE_S32LE:
+            ConvertS32ToS16(static_cast<const int32_t*>(src), count, dst);
+            return true;
+        case AUDIOSTREAM_SAMPLE_F32LE:
+            ConvertF32ToS16(static_cast<const float*>(src), count, dst);
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_SAMPLE_FORMAT_H
@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_samples_pool.h"
+#include "audio_sample_format.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+using namespace Napi;
+
+const char kResourceName[] = "AudioSamplesPool";
+
+const char kAttributeNameSamples[] = "samples";
+const char kAttributeNameSampleRate[] = "sampleRate";
+const char kAttributeNameAudioFormat[] = "audioFormat";
+const char kAttributeNameChannelCount[] = "channelCount";
+const char kAttributeNameData[] = "data";
+
+const char kMethodNameRelease[] = "release";
+
+AudioSamplesPool* AudioSamplesPool::Create(
+    Napi::Env env, Napi::Object owner, std::string handlerName, size_t bufferCount, int32_t intervalMs,
+    bool manualRelease)
+{
+    auto pool = new AudioSamplesPool(owner, std::move(handlerName), bufferCount, intervalMs, manualRelease);
+    pool->tsfn_ = TSFN::New(
+        env, kResourceName, bufferCount, 1, pool, [](Napi::Env, void*, AudioSamplesPool* ctx) { ctx->OnFinalize(); });
+
+    return pool;
+}
+
+AudioSamplesPool::AudioSamplesPool(
+    Napi::Object owner, std::string handlerName, size_t bufferCount, int32_t intervalMs, bool manualRelease)
+    : owner_(Napi::Weak(owner)), handlerName_(std::move(handlerName)), intervalMs_(intervalMs),
+      manualRelease_(manualRelease), freeBuffers_(bufferCount)
+{
+    RTC_DLOG(LS_INFO) << __FUNCTION__ << " bufferCount=" << bufferCount << ", intervalMs=" << intervalMs;
+
+    for (size_t i = 0; i < bufferCount; i++) {
+        buffers_.push_back(std::make_unique<Buffer>());
+        Buffer* buffer = buffers_.back().get();
+        freeBuffers_.Write(&buffer, 1);
+    }
+}
+
+AudioSamplesPool::~AudioSamplesPool()
+{
+    RTC_DLOG(LS_INFO) << __FUNCTION__;
+
+    alive_.reset();
+
+    for (auto& buffer : buffers_) {
+        if (buffer->data != buffer->wrapped) {
+            delete[] buffer->data;
+        }
+    }
+}
+
+void AudioSamplesPool::Write(int32_t sampleRate, int32_t channelCount, int32_t format, const void* data, size_t length)
+{
+    if (current_ &&
+        (current_->sampleRate != sampleRate || current_->channelCount != channelCount || current_->format != format))
+    {
+        // the layout has changed, the partial buffer is discarded
+        RTC_LOG(LS_INFO) << "Audio samples layout changed";
+        PrepareBuffer(current_, sampleRate, channelCount, format);
+        filled_ = 0;
+    }
+
+    auto src = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        if (!current_) {
+            current_ = Acquire(sampleRate, channelCount, format);
+            filled_ = 0;
+            if (!current_) {
+                // the js thread still holds all the buffers
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        size_t count = std::min(length, current_->size - filled_);
+        memcpy(current_->data + filled_, src, count);
+        filled_ += count;
+        src += count;
+        length -= count;
+
+        if (filled_ < current_->size) {
+            continue;
+        }
+
+        if (tsfn_.NonBlockingCall(current_) != napi_ok) {
+            // keep the buffer and overwrite it
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            filled_ = 0;
+        } else {
+            current_ = nullptr;
+        }
+    }
+}
+
+void AudioSamplesPool::Release()
+{
+    tsfn_.Release();
+}
+
+void AudioSamplesPool::OnFinalize()
+{
+    finalized_ = true;
+    if (heldCount_ == 0) {
+        delete this;
+    }
+}
+
+uint64_t AudioSamplesPool::GetDroppedCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioSamplesPool::GetOverflowCount() const
+{
+    return overflows_.load(std::memory_order_relaxed);
+}
+
+AudioSamplesPool::Buffer* AudioSamplesPool::Acquire(int32_t sampleRate, int32_t channelCount, int32_t format)
+{
+    Buffer* buffer = nullptr;
+    if (freeBuffers_.Read(&buffer, 1) == 0) {
+        return nullptr;
+    }
+
+    PrepareBuffer(buffer, sampleRate, channelCount, format);
+    return buffer;
+}
+
+void AudioSamplesPool::PrepareBuffer(Buffer* buffer, int32_t sampleRate, int32_t channelCount, int32_t format)
+{
+    const size_t frameSize = channelCount * std::max<size_t>(GetBytesPerSample(format), 1);
+    const size_t size = std::max<size_t>(sampleRate * intervalMs_ / rtc::kNumMillisecsPerSec, 1) * frameSize;
+    if (buffer->size != size) {
+        // memory already wrapped belongs to the ArrayBuffer, which is replaced on the next delivery
+        if (buffer->data != buffer->wrapped) {
+            delete[] buffer->data;
+        }
+        buffer->data = new uint8_t[size];
+        buffer->size = size;
+    }
+
+    buffer->sampleRate = sampleRate;
+    buffer->channelCount = channelCount;
+    buffer->format = format;
+}
+
+void AudioSamplesPool::CallJs(Napi::Env env, Napi::Function callback, AudioSamplesPool* context, Buffer* buffer)
+{
+    (void)callback;
+
+    if (env == nullptr) {
+        // Javascript environment is not available to call into, the buffers are freed with the pool
+        return;
+    }
+
+    context->Deliver(env, buffer);
+
+    if (!context->manualRelease_) {
+        // the handler is done with it
+        context->freeBuffers_.Write(&buffer, 1);
+    }
+}
+
+void AudioSamplesPool::Deliver(Napi::Env env, Buffer* buffer)
+{
+    if (manualRelease_) {
+        // returned to the pool by release(), even if nobody handles it
+        buffer->held = true;
+        heldCount_++;
+    }
+
+    auto owner = owner_.Value();
+    if (owner.IsEmpty()) {
+        Recycle(buffer);
+        return;
+    }
+
+    auto handler = owner.Get(handlerName_);
+    if (!handler.IsFunction()) {
+        Recycle(buffer);
+        return;
+    }
+
+    if (buffer->jsEvent.IsEmpty()) {
+        auto jsSamples = Object::New(env);
+        auto jsEvent = Object::New(env);
+        jsEvent.Set(kAttributeNameSamples, jsSamples);
+        if (manualRelease_) {
+            std::weak_ptr<bool> alive = alive_;
+            jsSamples.Set(
+                kMethodNameRelease, Function::New(env, [this, alive, buffer](const Napi::CallbackInfo&) {
+                    if (!alive.expired()) {
+                        Recycle(buffer);
+                    }
+                }));
+        }
+        buffer->jsSamples = Persistent(jsSamples);
+        buffer->jsEvent = Persistent(jsEvent);
+    }
+
+    auto jsSamples = buffer->jsSamples.Value();
+    if (buffer->wrapped != buffer->data) {
+        // wrap the memory once, from now on the ArrayBuffer frees it when it is collected
+        auto jsData = ArrayBuffer::New(
+            env, buffer->data, buffer->size, [](Napi::Env, void* data) { delete[] static_cast<uint8_t*>(data); });
+        buffer->wrapped = buffer->data;
+        buffer->jsData = Persistent(jsData);
+        jsSamples.Set(kAttributeNameData, jsData);
+    }
+
+    jsSamples.Set(kAttributeNameSampleRate, Number::New(env, buffer->sampleRate));
+    jsSamples.Set(kAttributeNameAudioFormat, Number::New(env, buffer->format));
+    jsSamples.Set(kAttributeNameChannelCount, Number::New(env, buffer->channelCount));
+
+    handler.As<Function>().Call(owner, {buffer->jsEvent.Value()});
+}
+
+void AudioSamplesPool::Recycle(Buffer* buffer)
+{
+    if (!buffer->held) {
+        // released more than once, or not held at all
+        return;
+    }
+
+    buffer->held = false;
+    heldCount_--;
+    if (finalized_) {
+        if (heldCount_ == 0) {
+            delete this;
+        }
+        return;
+    }
+
+    freeBuffers_.Write(&buffer, 1);
+}
+
+} // namespace webrtc
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_AUDIO_SAMPLES_POOL_H
+#define WEBRTC_AUDIO_SAMPLES_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "napi.h"
+
+#include "audio_fifo.h"
+
+namespace webrtc {
+
+// Deliver captured samples to ArkTS in a fixed set of preallocated buffers. The samples are gathered on the capture
+// thread into buffers of a fixed duration, and each full buffer is passed to the js thread, where its ArrayBuffer and
+// event object are created once and reused. By default a buffer is back in the pool as soon as the handler returns,
+// so the handler has to copy the data it wants to keep. With manual release the buffer is only reused after ArkTS
+// calls samples.release(), until then the capture thread never touches it.
+class AudioSamplesPool {
+public:
+    static constexpr size_t kDefaultBufferCount = 4;
+    static constexpr int32_t kDefaultIntervalMs = 10;
+
+    // The handler is looked up by name on the owner for every delivery. The owner is not kept alive by the pool.
+    static AudioSamplesPool* Create(
+        Napi::Env env, Napi::Object owner, std::string handlerName, size_t bufferCount, int32_t intervalMs,
+        bool manualRelease);
+
+    // Called on the capture thread.
+    void Write(int32_t sampleRate, int32_t channelCount, int32_t format, const void* data, size_t length);
+
+    // No more Write after this. The pool deletes itself once the pending buffers are delivered.
+    void Release();
+
+    // Full buffers which could not be passed to the js thread.
+    uint64_t GetDroppedCount() const;
+    // Writes which found no free buffer, the samples were discarded.
+    uint64_t GetOverflowCount() const;
+
+protected:
+    struct Buffer {
+        // owned by jsData once wrapped, see Deliver
+        uint8_t* data{};
+        size_t size{0};
+        int32_t sampleRate{0};
+        int32_t channelCount{0};
+        int32_t format{0};
+
+        // accessed on the js thread only
+        bool held{false};
+        uint8_t* wrapped{};
+        Napi::Reference<Napi::ArrayBuffer> jsData;
+        Napi::ObjectReference jsEvent;
+        Napi::ObjectReference jsSamples;
+    };
+
+    static void CallJs(Napi::Env env, Napi::Function callback, AudioSamplesPool* context, Buffer* buffer);
+    using TSFN = Napi::TypedThreadSafeFunction<AudioSamplesPool, Buffer, CallJs>;
+
+    AudioSamplesPool(
+        Napi::Object owner, std::string handlerName, size_t bufferCount, int32_t intervalMs, bool manualRelease);
+    ~AudioSamplesPool();
+
+    // Called on the js thread once the tsfn is finalized, the pool is deleted when no buffer is held by ArkTS.
+    void OnFinalize();
+
+    // Take a free buffer with room for one interval of the layout, nullptr if there is none.
+    Buffer* Acquire(int32_t sampleRate, int32_t channelCount, int32_t format);
+    void PrepareBuffer(Buffer* buffer, int32_t sampleRate, int32_t channelCount, int32_t format);
+    void Deliver(Napi::Env env, Buffer* buffer);
+    // Called on the js thread when ArkTS is done with the buffer.
+    void Recycle(Buffer* buffer);
+
+private:
+    TSFN tsfn_;
+    Napi::ObjectReference owner_;
+    const std::string handlerName_;
+    const int32_t intervalMs_;
+    const bool manualRelease_;
+
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+    // pushed on the js thread, popped on the capture thread
+    AudioFifo<Buffer*> freeBuffers_;
+
+    // accessed on the capture thread only
+    Buffer* current_{};
+    size_t filled_{0};
+
+    // accessed on the js thread only
+    size_t heldCount_{0};
+    bool finalized_{false};
+    // expires with the pool, for release() called on a samples object kept after that
+    std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> overflows_{0};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_AUDIO_SAMPLES_POOL_H
@@ -15,18 +15,20 @@
 
 #include "mixing_audio_input.h"
 #include "audio_common.h"
+#include "audio_fifo.h"
+#include "audio_mix_kernel.h"
+#include "audio_sample_format.h"
 
-#include "common_audio/ring_buffer.h"
 #include "common_audio/resampler/include/push_resampler.h"
-#include "modules/audio_mixer/audio_mixer_impl.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 
 #include <cmath>
-#include <queue>
-#include <fstream>
-#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 
 namespace webrtc {
 
@@ -37,31 +39,43 @@ constexpr int32_t kFrameDurationInMs = 10;
 
 constexpr int32_t kBufferDurationInMs = 200;
 
+// How long the mixing waits for a late frame of the master input, other inputs are never waited for.
+constexpr int32_t kMaxSourceWaitInMs = 3;
+
+// Mixing is paced to keep about this much buffered for the master input.
+constexpr int64_t kTargetBufferedUs = 20 * rtc::kNumMicrosecsPerMillisec;
+// Each ms away from the target shortens or lengthens the mixing period by 10 us, up to 5% of the period.
+constexpr int64_t kDriftCorrectionDivisor = 100;
+constexpr int64_t kMaxDriftCorrectionUs = 500;
+
+// Beyond this the mixing gives up catching up, for example after the thread has been suspended.
+constexpr int32_t kMaxLagInMs = 100;
+
+// The gain of the mix drops at once to keep the sum of the inputs from clipping, and recovers by this factor per
+// frame, about 0.4 dB.
+constexpr float kMaxMixLevel = 32767.0f;
+constexpr float kLimiterRecovery = 1.05f;
+
 } // namespace
 
-class AudioMixerSourceAdapter : public AudioMixer::Source, public AudioInput::Observer {
+class AudioMixerSourceAdapter : public AudioInput::Observer {
 public:
     explicit AudioMixerSourceAdapter(std::shared_ptr<AudioInput> input, int ssrc = 0)
-        : input_(std::move(input)), ssrc_(ssrc)
+        : input_(std::move(input)), ssrc_(ssrc),
+          fifo_(input_->GetSampleRate() * input_->GetChannelCount() / rtc::kNumMillisecsPerSec * kBufferDurationInMs)
     {
         RTC_DLOG(LS_INFO) << __FUNCTION__;
 
         RTC_DCHECK(input_);
 
-        buffer_ = WebRtc_CreateBuffer(
-            input_->GetSampleRate() * input_->GetChannelCount() / rtc::kNumMillisecsPerSec * kBufferDurationInMs,
-            sizeof(int16_t));
-        RTC_CHECK(buffer_);
-
         input_->RegisterObserver(this);
+        // an input joining a live mix may be recording already
+        running_.store(input_->Recording(), std::memory_order_release);
     }
 
     ~AudioMixerSourceAdapter() override
     {
         input_->UnregisterObserver(this);
-
-        std::lock_guard<std::mutex> lock(mutex_);
-        WebRtc_FreeBuffer(buffer_);
     }
 
     const std::shared_ptr<AudioInput>& GetInput() const
@@ -69,60 +83,114 @@ public:
         return input_;
     }
 
-protected:
-    // AudioInput::Observer Implementation.
-    AudioFrameInfo GetAudioFrameWithInfo(int targetSampleRate, AudioFrame* frame) override
+    uint64_t GetUnderrunCount() const
     {
-        frame->samples_per_channel_ = targetSampleRate / rtc::kNumMillisecsPerSec * kFrameDurationInMs;
-        frame->sample_rate_hz_ = targetSampleRate;
-        frame->num_channels_ = input_->GetChannelCount();
-
-        // Read 10ms
-        const size_t numToRead =
-            input_->GetChannelCount() * input_->GetSampleRate() / rtc::kNumMillisecsPerSec * kFrameDurationInMs;
-
-        std::unique_lock<std::mutex> lock(mutex_);
-        dirtyCondVar_.wait(
-            lock, [this, numToRead] { return (WebRtc_available_read(buffer_) >= numToRead) || !running_; });
-        if (!running_) {
-            // Stopped
-            return AudioFrameInfo::kError;
-        }
+        return underruns_.load(std::memory_order_relaxed);
+    }
 
-        if (targetSampleRate != input_->GetSampleRate()) {
-            if (!resampler_) {
-                resampler_ = std::make_unique<PushResampler<int16_t>>();
-            }
-            resampler_->InitializeIfNeeded(input_->GetSampleRate(), targetSampleRate, input_->GetChannelCount());
-            if (tempData_.size() < numToRead) {
-                tempData_.resize(numToRead);
-            }
+    uint64_t GetOverrunCount() const
+    {
+        return overruns_.load(std::memory_order_relaxed);
+    }
 
-            void* data = nullptr;
-            const size_t read = WebRtc_ReadBuffer(buffer_, &data, tempData_.data(), numToRead);
-            RTC_CHECK_EQ(read, numToRead);
-            resampler_->Resample(
-                static_cast<int16_t*>(data), numToRead, frame->mutable_data(), frame->max_16bit_samples());
-        } else {
-            const size_t read = WebRtc_ReadBuffer(buffer_, nullptr, frame->mutable_data(), numToRead);
-            RTC_CHECK_EQ(read, numToRead);
-        }
+    bool IsRunning() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
 
-        freeCondVar_.notify_all();
+    // Whether a whole 10 ms frame is buffered.
+    bool HasFrame() const
+    {
+        return fifo_.AvailableRead() >= GetSamplesPerFrame();
+    }
 
-        return AudioFrameInfo::kNormal;
+    int64_t GetBufferedUs() const
+    {
+        return fifo_.AvailableRead() * rtc::kNumMicrosecsPerSec / (input_->GetSampleRate() * input_->GetChannelCount());
     }
 
-    int Ssrc() const override
+    // Delay from the capture of the end of the last frame read by the mixer, to the moment it was read.
+    // Called on the mixing thread.
+    int64_t GetLastFrameDelayUs() const
     {
-        return ssrc_;
+        return lastFrameDelayUs_;
     }
 
-    int PreferredSampleRate() const override
+    float GetGain() const
     {
-        return input_->GetSampleRate();
+        return gain_.load(std::memory_order_relaxed);
     }
 
+    void SetGain(float gain)
+    {
+        gain_.store(gain, std::memory_order_relaxed);
+    }
+
+    // Add the next 10 ms of the input, scaled by the gain, to the interleaved accumulator of the mix, never wait for
+    // the input. Return false if nothing was added. Called on the mixing thread.
+    bool MixInto(int targetSampleRate, int targetChannels, float* dst)
+    {
+        if (clearRequested_.exchange(false, std::memory_order_acquire)) {
+            // drop what is left from the previous recording
+            fifo_.Clear();
+        }
+
+        if (!running_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        const int channels = input_->GetChannelCount();
+        const float gain = GetGain();
+        const size_t numToRead = GetSamplesPerFrame();
+
+        size_t read = 0;
+        if (targetSampleRate == input_->GetSampleRate()) {
+            // mix straight out of the fifo
+            size_t mixedFrames = 0;
+            read = fifo_.Consume(numToRead, [&](const int16_t* data, size_t count) {
+                MixS16(data, count / channels, channels, targetChannels, gain, dst + mixedFrames * targetChannels);
+                mixedFrames += count / channels;
+            });
+        } else {
+            // Not fused: PushResampler only takes contiguous int16 samples, so the input is copied out of the fifo,
+            // resampled to another int16 buffer and only then mixed. Both buffers are allocated once per input.
+            if (tempData_.size() < numToRead) {
+                tempData_.resize(numToRead);
+            }
+
+            read = fifo_.Read(tempData_.data(), numToRead);
+            if (read > 0) {
+                // conceal the missing part with silence
+                std::fill(tempData_.begin() + read, tempData_.begin() + numToRead, 0);
+
+                const size_t targetFrames = targetSampleRate / rtc::kNumMillisecsPerSec * kFrameDurationInMs;
+                if (resampledData_.size() < targetFrames * channels) {
+                    resampledData_.resize(targetFrames * channels);
+                }
+                if (!resampler_) {
+                    resampler_ = std::make_unique<PushResampler<int16_t>>();
+                }
+                resampler_->InitializeIfNeeded(input_->GetSampleRate(), targetSampleRate, channels);
+                resampler_->Resample(tempData_.data(), numToRead, resampledData_.data(), resampledData_.size());
+                MixS16(resampledData_.data(), targetFrames, channels, targetChannels, gain, dst);
+            }
+        }
+
+        if (read < numToRead) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            if (read == 0) {
+                return false;
+            }
+        }
+
+        // the samples left in the fifo were captured after the end of this frame
+        auto sinceArrivalUs = std::max<int64_t>(0, rtc::TimeMicros() - lastArrivalUs_.load(std::memory_order_relaxed));
+        lastFrameDelayUs_ = sinceArrivalUs + lastInputDelayUs_.load(std::memory_order_relaxed) + GetBufferedUs();
+
+        return true;
+    }
+
+protected:
     // AudioInput::Observer Implementation
     void OnAudioInputError(AudioInput* input, AudioErrorType type, const std::string& message) override
     {
@@ -135,17 +203,13 @@ protected:
         switch (newState) {
             case AudioStateType::START: {
                 RTC_LOG(LS_INFO) << "[" << ssrc_ << "]" << "Start";
-                std::lock_guard<std::mutex> lock(mutex_);
-                running_ = true;
-                WebRtc_InitBuffer(buffer_);
+                clearRequested_.store(true, std::memory_order_release);
+                running_.store(true, std::memory_order_release);
                 break;
             }
             case AudioStateType::STOP: {
                 RTC_LOG(LS_INFO) << "[" << ssrc_ << "]" << "Stop";
-                std::lock_guard<std::mutex> lock(mutex_);
-                running_ = false;
-                dirtyCondVar_.notify_all();
-                freeCondVar_.notify_all();
+                running_.store(false, std::memory_order_release);
                 break;
             }
             default:
@@ -153,42 +217,77 @@ protected:
         }
     }
 
+    // Called on the capture thread of the input.
     void OnAudioInputDataReady(
         AudioInput* input, void* buffer, int32_t length, int64_t timestampUs, int64_t deleyUs) override
     {
         RTC_DLOG(LS_VERBOSE) << "[" << ssrc_ << "]" << __FUNCTION__;
 
-        size_t numToWritten = length / sizeof(int16_t);
-
-        std::unique_lock<std::mutex> lock(mutex_);
-        auto ret = freeCondVar_.wait_for(lock, std::chrono::milliseconds(kFrameDurationInMs), [this, numToWritten] {
-            return (WebRtc_available_write(buffer_) >= numToWritten) || !running_;
-        });
-        if (!running_) {
+        if (!running_.load(std::memory_order_acquire)) {
             // Stopped
             return;
-        } else if (!ret) {
-            // Timeout
-            RTC_LOG(LS_WARNING) << "[" << ssrc_ << "]" << "Timeout";
+        }
+
+        // the timestamps of inputs may come from different clocks, so the arrival is timed here
+        lastArrivalUs_.store(rtc::TimeMicros(), std::memory_order_relaxed);
+        lastInputDelayUs_.store(deleyUs, std::memory_order_relaxed);
+
+        const int32_t format = input_->GetSampleFormat();
+        const size_t bytesPerSample = GetBytesPerSample(format);
+        if (bytesPerSample == 0) {
             return;
         }
 
-        const size_t written = WebRtc_WriteBuffer(buffer_, buffer, numToWritten);
-        RTC_CHECK_EQ(written, numToWritten);
-        dirtyCondVar_.notify_all();
+        const int16_t* data = static_cast<const int16_t*>(buffer);
+        size_t numToWrite = length / bytesPerSample;
+        if (format != AUDIOSTREAM_SAMPLE_S16LE) {
+            // the fifo and the mixer work on int16, convert once on the way in
+            if (convertData_.size() < numToWrite) {
+                convertData_.resize(numToWrite);
+            }
+            ConvertToS16(format, buffer, numToWrite, convertData_.data());
+            data = convertData_.data();
+        }
+
+        // only whole frames, the mixing relies on the channels staying in place
+        const size_t channels = input_->GetChannelCount();
+        const size_t writable = std::min(numToWrite, fifo_.AvailableWrite() / channels * channels);
+        const size_t written = fifo_.Write(data, writable);
+        if (written < numToWrite) {
+            // the mixer is behind, drop the samples which do not fit
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    size_t GetSamplesPerFrame() const
+    {
+        return input_->GetChannelCount() * input_->GetSampleRate() / rtc::kNumMillisecsPerSec * kFrameDurationInMs;
     }
 
 private:
     std::shared_ptr<AudioInput> input_;
     const int ssrc_;
-    bool running_{false};
-    RingBuffer* buffer_{};
-    std::mutex mutex_;
-    std::condition_variable dirtyCondVar_;
-    std::condition_variable freeCondVar_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> clearRequested_{false};
+    std::atomic<float> gain_{1.0f};
+
+    // written on the capture thread of the input, read on the mixing thread
+    AudioFifo<int16_t> fifo_;
+
+    std::atomic<uint64_t> underruns_{0};
+    std::atomic<uint64_t> overruns_{0};
 
+    std::atomic<int64_t> lastArrivalUs_{0};
+    std::atomic<int64_t> lastInputDelayUs_{0};
+    // accessed on the capture thread of the input only
+    std::vector<int16_t> convertData_;
+
+    // accessed on the mixing thread only
+    int64_t lastFrameDelayUs_{0};
     std::unique_ptr<PushResampler<int16_t>> resampler_;
     std::vector<int16_t> tempData_;
+    std::vector<int16_t> resampledData_;
 };
 
 int MixingAudioInput::CalculateOutputSampleRate(const std::list<std::shared_ptr<AudioInput>>& inputs)
@@ -236,7 +335,7 @@ std::unique_ptr<MixingAudioInput> MixingAudioInput::Create(AudioInputOptions opt
 }
 
 MixingAudioInput::MixingAudioInput(AudioInputOptions options)
-    : AudioInputBase(std::move(options)), mixer_(webrtc::AudioMixerImpl::Create()), thread_(rtc::Thread::Create())
+    : AudioInputBase(std::move(options)), thread_(rtc::Thread::Create())
 {
     RTC_DLOG(LS_INFO) << __FUNCTION__;
 
@@ -340,6 +439,7 @@ int32_t MixingAudioInput::StartRecording()
     }
 
     recording_ = true;
+    callbackStats_.OnStreamStart();
 
     thread_->Start();
     thread_->PostTask([this] { DoMix(); });
@@ -362,6 +462,8 @@ int32_t MixingAudioInput::StopRecording()
         std::lock_guard<std::mutex> lock(sourcesMutex_);
         for (auto& source : sources_) {
             source->GetInput()->StopRecording();
+            RTC_LOG(LS_INFO) << source->GetInput()->GetLabel() << " underruns: " << source->GetUnderrunCount()
+                             << ", overruns: " << source->GetOverrunCount();
         }
     }
 
@@ -391,18 +493,26 @@ bool MixingAudioInput::AddAudioInput(std::shared_ptr<AudioInput> input)
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(sourcesMutex_);
-    auto it = std::find_if(sources_.begin(), sources_.end(), [&input](const auto& e) {
-        return e->GetInput() == input;
-    });
-    if (it != sources_.end()) {
-        RTC_LOG(LS_WARNING) << "Input already added";
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        auto it = std::find_if(sources_.begin(), sources_.end(), [&input](const auto& e) {
+            return e->GetInput() == input;
+        });
+        if (it != sources_.end()) {
+            RTC_LOG(LS_WARNING) << "Input already added";
+            return false;
+        }
+
+        sources_.push_back(std::make_shared<AudioMixerSourceAdapter>(input, nextSourceId_++));
     }
 
-    auto adapter = std::make_shared<AudioMixerSourceAdapter>(input, sources_.size());
-    mixer_->AddSource(adapter.get());
-    sources_.push_back(adapter);
+    if (recording_) {
+        // join the live mix, the output format stays the same and the other inputs go on
+        RTC_DCHECK(threadChecker_.IsCurrent());
+        input->Init();
+        input->InitRecording();
+        input->StartRecording();
+    }
 
     return true;
 }
@@ -413,6 +523,44 @@ bool MixingAudioInput::RemoveAudioInput(std::shared_ptr<AudioInput> input)
 
     RTC_DCHECK(input);
 
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        auto it =
+            std::find_if(sources_.begin(), sources_.end(), [&input](const auto& e) { return e->GetInput() == input; });
+        if (it == sources_.end()) {
+            RTC_LOG(LS_WARNING) << "Input not present";
+            return false;
+        }
+
+        // the mixing holds the lock while it uses the sources
+        sources_.erase(it);
+    }
+
+    if (recording_) {
+        // leave the live mix
+        RTC_DCHECK(threadChecker_.IsCurrent());
+        input->StopRecording();
+    }
+
+    return true;
+}
+
+std::vector<std::shared_ptr<AudioInput>> MixingAudioInput::GetAudioInputs()
+{
+    std::vector<std::shared_ptr<AudioInput>> result;
+
+    std::lock_guard<std::mutex> lock(sourcesMutex_);
+    for (const auto& source : sources_) {
+        result.push_back(source->GetInput());
+    }
+
+    return result;
+}
+
+bool MixingAudioInput::SetInputGain(std::shared_ptr<AudioInput> input, float gain)
+{
+    RTC_DLOG(LS_INFO) << __FUNCTION__ << ": " << input.get() << ", " << gain;
+
     std::lock_guard<std::mutex> lock(sourcesMutex_);
     auto it =
         std::find_if(sources_.begin(), sources_.end(), [&input](const auto& e) { return e->GetInput() == input; });
@@ -421,32 +569,116 @@ bool MixingAudioInput::RemoveAudioInput(std::shared_ptr<AudioInput> input)
         return false;
     }
 
-    sources_.erase(it);
-    mixer_->RemoveSource(it->get());
+    (*it)->SetGain(gain);
 
     return true;
 }
 
 void MixingAudioInput::DoMix()
 {
-    AudioFrame frame;
+    const int32_t sampleRate = GetSampleRate();
+    const int32_t channelCount = GetChannelCount();
+    const size_t samplesPerFrame = channelCount * sampleRate / rtc::kNumMillisecsPerSec * kFrameDurationInMs;
+
+    // allocated once for the whole recording
+    std::vector<float> mixData(samplesPerFrame);
+    std::vector<int16_t> frameData(samplesPerFrame);
+    float limiterGain = 1.0f;
+
+    const auto framePeriod = std::chrono::milliseconds(kFrameDurationInMs);
+    auto deadline = std::chrono::steady_clock::now();
 
     while (recording_) {
-        auto begin = std::chrono::steady_clock::now();
+        auto master = GetMasterSource();
+        if (master) {
+            // a late frame of the master input is worth a short wait, instead of a gap in the mix
+            auto waitUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(kMaxSourceWaitInMs);
+            while (recording_ && !master->HasFrame() && std::chrono::steady_clock::now() < waitUntil) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        const int64_t beginUs = callbackStats_.BeginCallback();
 
-        mixer_->Mix(GetChannelCount(), &frame);
-        RTC_CHECK_EQ(GetChannelCount(), frame.num_channels());
-        RTC_CHECK_EQ(GetSampleRate(), frame.sample_rate_hz());
-        RTC_CHECK_EQ(GetSampleRate() / rtc::kNumMillisecsPerSec * kFrameDurationInMs, frame.samples_per_channel());
+        std::fill(mixData.begin(), mixData.end(), 0.0f);
+        {
+            std::lock_guard<std::mutex> lock(sourcesMutex_);
+            for (auto& source : sources_) {
+                source->MixInto(sampleRate, channelCount, mixData.data());
+            }
+        }
+
+        float peak = GetPeakLevel(mixData.data(), samplesPerFrame);
+        float targetGain = peak > kMaxMixLevel ? kMaxMixLevel / peak : 1.0f;
+        limiterGain = std::min({1.0f, targetGain, limiterGain * kLimiterRecovery});
 
         if (mute_) {
-            frame.Mute();
+            std::fill(frameData.begin(), frameData.end(), 0);
+        } else {
+            StoreS16(mixData.data(), samplesPerFrame, limiterGain, frameData.data());
         }
 
-        // Timestamp and deley
         NotifyDataReady(
-            (void*)frame.data(), frame.num_channels() * frame.samples_per_channel() * sizeof(int16_t), 0, 0);
+            frameData.data(), samplesPerFrame * sizeof(int16_t), rtc::TimeMicros(),
+            master ? master->GetLastFrameDelayUs() : 0);
+
+        callbackStats_.EndCallback(
+            beginUs, samplesPerFrame / channelCount, sampleRate,
+            master ? static_cast<int32_t>(master->GetBufferedUs() / rtc::kNumMicrosecsPerMillisec) : 0);
+
+        // Run on a monotonic 10 ms clock, slightly adjusted to follow the clock of the master input: consume faster
+        // when its samples pile up, and slower when they run short.
+        auto period = std::chrono::duration_cast<std::chrono::microseconds>(framePeriod);
+        if (master) {
+            auto correctionUs = std::clamp<int64_t>(
+                (master->GetBufferedUs() - kTargetBufferedUs) / kDriftCorrectionDivisor, -kMaxDriftCorrectionUs,
+                kMaxDriftCorrectionUs);
+            period -= std::chrono::microseconds(correctionUs);
+        }
+        deadline += period;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - deadline > std::chrono::milliseconds(kMaxLagInMs)) {
+            RTC_LOG(LS_WARNING) << "Mixing is late by "
+                                << std::chrono::duration_cast<std::chrono::milliseconds>(now - deadline).count()
+                                << " ms, skip ahead";
+            callbackStats_.AddGlitch(
+                AudioGlitchType::LATE_CALLBACK,
+                std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count());
+            deadline = now;
+        }
+
+        std::this_thread::sleep_until(deadline);
+    }
+}
+
+std::shared_ptr<AudioMixerSourceAdapter> MixingAudioInput::GetMasterSource()
+{
+    std::lock_guard<std::mutex> lock(sourcesMutex_);
+    for (const auto& source : sources_) {
+        if (source->IsRunning()) {
+            return source;
+        }
     }
+
+    return nullptr;
+}
+
+const AudioCallbackStats* MixingAudioInput::GetCallbackStats() const
+{
+    return &callbackStats_;
+}
+
+std::vector<MixingAudioInput::SourceStats> MixingAudioInput::GetSourceStats()
+{
+    std::vector<SourceStats> result;
+
+    std::lock_guard<std::mutex> lock(sourcesMutex_);
+    for (const auto& source : sources_) {
+        result.push_back({source->GetInput()->GetLabel(), source->GetUnderrunCount(), source->GetOverrunCount()});
+    }
+
+    return result;
 }
 
 void MixingAudioInput::OnAudioInputError(AudioInput* input, AudioErrorType type, const std::string& message)
@@ -21,7 +21,6 @@
 #include <string>
 #include <vector>
 
-#include "api/audio/audio_mixer.h"
 #include "modules/audio_device/audio_device_buffer.h"
 #include "modules/audio_device/fine_audio_buffer.h"
 #include "rtc_base/thread.h"
@@ -53,11 +52,30 @@ public:
     int32_t StopRecording() override;
     bool Recording() const override;
 
+    // Inputs can be added and removed while recording, they are started and stopped with it.
     bool AddAudioInput(std::shared_ptr<AudioInput> input);
     bool RemoveAudioInput(std::shared_ptr<AudioInput> input);
+    std::vector<std::shared_ptr<AudioInput>> GetAudioInputs();
+    // Linear gain applied to the input in the mix, 1 by default.
+    bool SetInputGain(std::shared_ptr<AudioInput> input, float gain);
+
+    struct SourceStats {
+        std::string label;
+        // 10 ms frames which the input could not fill in time, concealed with silence
+        uint64_t underruns;
+        // writes of the input which did not fit, the rest of them were dropped
+        uint64_t overruns;
+    };
+
+    std::vector<SourceStats> GetSourceStats();
+
+    // Telemetry of the 10 ms mixing ticks.
+    const AudioCallbackStats* GetCallbackStats() const override;
 
 protected:
     void DoMix();
+    // The first running input, the mixing follows its clock.
+    std::shared_ptr<AudioMixerSourceAdapter> GetMasterSource();
 
     void OnAudioInputError(AudioInput* input, AudioErrorType type, const std::string& message) override;
     void OnAudioInputStateChange(AudioInput* input, AudioStateType newState) override;
@@ -67,15 +85,16 @@ protected:
 private:
     SequenceChecker threadChecker_;
 
-    rtc::scoped_refptr<AudioMixer> mixer_;
-
     std::mutex sourcesMutex_;
     std::vector<std::shared_ptr<AudioMixerSourceAdapter>> sources_;
+    int nextSourceId_{0};
 
     std::unique_ptr<rtc::Thread> thread_;
 
     bool initialized_{false};
     std::atomic<bool> recording_{false};
+
+    AudioCallbackStats callbackStats_;
 };
 
 } // namespace webrtc
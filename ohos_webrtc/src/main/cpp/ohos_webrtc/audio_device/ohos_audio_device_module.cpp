@@ -17,6 +17,7 @@
 #include "audio_common.h"
 #include "audio_capturer.h"
 #include "audio_renderer.h"
+#include "audio_sample_format.h"
 #include "mixing_audio_input.h"
 
 #include <memory>
@@ -26,6 +27,7 @@
 #include "api/task_queue/default_task_queue_factory.h"
 #include "modules/audio_device/audio_device_buffer.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
@@ -38,10 +40,16 @@ const char kAttributeNameOnCapturerStateChange[] = "oncapturerstatechange";
 const char kAttributeNameOnCapturerSamplesReady[] = "oncapturersamplesready";
 const char kAttributeNameOnRendererError[] = "onrenderererror";
 const char kAttributeNameOnRendererStateChange[] = "onrendererstatechange";
+const char kAttributeNameOnAudioLevel[] = "onaudiolevel";
 
 const char kMethodNameSetSpeakerMute[] = "setSpeakerMute";
 const char kMethodNameSetMicrophoneMute[] = "setMicrophoneMute";
 const char kMethodNameSetNoiseSuppressorEnabled[] = "setNoiseSuppressorEnabled";
+const char kMethodNameGetDelayStats[] = "getDelayStats";
+const char kMethodNameSetSamplesEventOptions[] = "setSamplesEventOptions";
+const char kMethodNameGetSamplesEventStats[] = "getSamplesEventStats";
+const char kMethodNameGetAudioLevels[] = "getAudioLevels";
+const char kMethodNameGetCallbackStats[] = "getCallbackStats";
 const char kMethodNameIsBuiltInAcousticEchoCancelerSupported[] = "isBuiltInAcousticEchoCancelerSupported";
 const char kMethodNameIsBuiltInNoiseSuppressorSupported[] = "isBuiltInNoiseSuppressorSupported";
 const char kMethodNameToJson[] = "toJSON";
@@ -51,6 +59,7 @@ const char kEventNameCapturerStateChange[] = "capturerstatechange";
 const char kEventNameCapturerSamplesReady[] = "capturersamplesready";
 const char kEventNameRendererError[] = "renderererror";
 const char kEventNameRendererStateChange[] = "rendererstatechange";
+const char kEventNameAudioLevel[] = "audiolevel";
 
 const char kAttributeNameAudioSource[] = "audioSource";
 const char kAttributeNameAudioFormat[] = "audioFormat";
@@ -60,6 +69,40 @@ const char kAttributeNameOutputSampleRate[] = "outputSampleRate";
 const char kAttributeNameUseStereoOutput[] = "useStereoOutput";
 const char kAttributeNameRendererUsage[] = "rendererUsage";
 const char kAttributeNameUseLowLatency[] = "useLowLatency";
+const char kAttributeNameAudioBufferDuration[] = "audioBufferDuration";
+const char kAttributeNameRecordDelay[] = "recordDelay";
+const char kAttributeNamePlayoutDelay[] = "playoutDelay";
+const char kAttributeNameCombinedDelay[] = "combinedDelay";
+const char kAttributeNamePooled[] = "pooled";
+const char kAttributeNameBufferCount[] = "bufferCount";
+const char kAttributeNameInterval[] = "interval";
+const char kAttributeNameManualRelease[] = "manualRelease";
+const char kAttributeNameDroppedCount[] = "droppedCount";
+const char kAttributeNameOverflowCount[] = "overflowCount";
+const char kAttributeNameAudioLevelInterval[] = "audioLevelInterval";
+const char kAttributeNameInput[] = "input";
+const char kAttributeNameOutput[] = "output";
+const char kAttributeNameRms[] = "rms";
+const char kAttributeNamePeak[] = "peak";
+const char kAttributeNameVoiceActive[] = "voiceActive";
+const char kAttributeNamePlayout[] = "playout";
+const char kAttributeNameMix[] = "mix";
+const char kAttributeNameCapture[] = "capture";
+const char kAttributeNameSources[] = "sources";
+const char kAttributeNameUnderrunCount[] = "underrunCount";
+const char kAttributeNameOverrunCount[] = "overrunCount";
+const char kAttributeNameLabel[] = "label";
+const char kAttributeNameCallbackCount[] = "callbackCount";
+const char kAttributeNameIntervalHistogram[] = "intervalHistogram";
+const char kAttributeNameDurationHistogram[] = "durationHistogram";
+const char kAttributeNameFillHistogram[] = "fillHistogram";
+const char kAttributeNameGlitchCount[] = "glitchCount";
+const char kAttributeNameRecentGlitches[] = "recentGlitches";
+const char kAttributeNameTimestamp[] = "timestamp";
+const char kAttributeNameType[] = "type";
+const char kAttributeNameValue[] = "value";
+
+constexpr int32_t kDefaultAudioLevelIntervalMs = 100;
 const char kAttributeNameUseHardwareAcousticEchoCanceler[] = "useHardwareAcousticEchoCanceler";
 const char kAttributeNameUseHardwareNoiseSuppressor[] = "useHardwareNoiseSuppressor";
 
@@ -139,19 +182,17 @@ void OhosAudioDeviceModule::AddAudioInput(std::shared_ptr<AudioInput> input)
         return;
     }
 
-    RTC_DCHECK(!Recording());
-    if (Recording()) {
-        RTC_LOG(LS_WARNING) << "Can not add input while recording";
-        return;
-    }
+    {
+        std::lock_guard<std::mutex> lock(mut_);
+        if (std::find(inputs_.begin(), inputs_.end(), input) != inputs_.end()) {
+            RTC_LOG(LS_INFO) << "The audio input already added";
+            return;
+        }
 
-    std::lock_guard<std::mutex> lock(mut_);
-    if (std::find(inputs_.begin(), inputs_.end(), input) != inputs_.end()) {
-        RTC_LOG(LS_INFO) << "The audio input already added";
-        return;
+        inputs_.push_back(input);
     }
 
-    inputs_.push_back(input);
+    PostUpdateRecordingInputs();
 }
 
 void OhosAudioDeviceModule::RemoveAudioInput(std::shared_ptr<AudioInput> input)
@@ -159,14 +200,89 @@ void OhosAudioDeviceModule::RemoveAudioInput(std::shared_ptr<AudioInput> input)
     RTC_LOG(LS_INFO) << __FUNCTION__;
 
     RTC_DCHECK(input);
-    RTC_DCHECK(!Recording());
-    if (Recording()) {
-        RTC_LOG(LS_WARNING) << "Can not add input while recording";
+
+    {
+        std::lock_guard<std::mutex> lock(mut_);
+        inputs_.remove(input);
+    }
+
+    PostUpdateRecordingInputs();
+}
+
+void OhosAudioDeviceModule::PostUpdateRecordingInputs()
+{
+    rtc::Thread* thread = recordingThread_.load(std::memory_order_acquire);
+    if (!thread) {
+        // never recorded, InitRecording picks up the inputs
         return;
     }
 
+    thread->PostTask([self = rtc::scoped_refptr<OhosAudioDeviceModule>(this)] { self->UpdateRecordingInputs(); });
+}
+
+void OhosAudioDeviceModule::UpdateRecordingInputs()
+{
+    RTC_LOG(LS_INFO) << __FUNCTION__;
+
+    RTC_DCHECK(threadChecker_.IsCurrent());
+    if (!initialized_ || !Recording()) {
+        // the next InitRecording picks up the inputs
+        return;
+    }
+
+    std::list<std::shared_ptr<AudioInput>> inputs;
+    {
+        std::lock_guard<std::mutex> lock(mut_);
+        inputs = inputs_.empty() ? std::list<std::shared_ptr<AudioInput>>{defaultInput_} : inputs_;
+    }
+
+    if (mixingInput_) {
+        // already mixing, change the inputs of the live mix
+        auto mixedInputs = mixingInput_->GetAudioInputs();
+        for (auto& input : mixedInputs) {
+            if (std::find(inputs.begin(), inputs.end(), input) == inputs.end()) {
+                mixingInput_->RemoveAudioInput(input);
+            }
+        }
+        for (auto& input : inputs) {
+            if (std::find(mixedInputs.begin(), mixedInputs.end(), input) == mixedInputs.end()) {
+                mixingInput_->AddAudioInput(input);
+            }
+        }
+        return;
+    }
+
+    if (inputs.size() == 1 && inputs.front() == input_) {
+        return;
+    }
+
+    // Switch from the single input to a mix, with the format being recorded, so that the audio device buffer goes on
+    // as is. The current input keeps recording if it is still wanted, only the frames in flight during the switch
+    // may be lost.
+    AudioInputOptions inputOptions;
+    inputOptions.sampleRate = input_->GetSampleRate();
+    inputOptions.channelCount = input_->GetChannelCount();
+
+    auto mixerInput = std::make_shared<MixingAudioInput>(inputOptions);
+    for (auto& input : inputs) {
+        mixerInput->AddAudioInput(input);
+    }
+    mixerInput->Init();
+    mixerInput->InitRecording();
+    mixerInput->SetMute(microphoneMute_);
+
+    // the old input delivers nothing more once the observer is removed
+    input_->UnregisterObserver(this);
+    if (std::find(inputs.begin(), inputs.end(), input_) == inputs.end()) {
+        input_->StopRecording();
+    }
+
+    mixerInput->RegisterObserver(this);
+    mixerInput->StartRecording();
+
     std::lock_guard<std::mutex> lock(mut_);
-    inputs_.remove(input);
+    input_ = mixerInput;
+    mixingInput_ = mixerInput;
 }
 
 rtc::scoped_refptr<OhosLocalAudioSource> OhosAudioDeviceModule::CreateAudioSource(
@@ -180,6 +296,52 @@ rtc::scoped_refptr<OhosLocalAudioSource> OhosAudioDeviceModule::CreateAudioSourc
     return OhosLocalAudioSource::Create(std::move(options), std::move(audioInput));
 }
 
+OhosAudioDeviceModule::DelayStats OhosAudioDeviceModule::GetDelayStats() const
+{
+    DelayStats stats;
+    stats.recordDelayMs = recordDelayMs_.load(std::memory_order_relaxed);
+    stats.playoutDelayMs = playoutDelayMs_.load(std::memory_order_relaxed);
+    stats.combinedDelayMs = stats.recordDelayMs + stats.playoutDelayMs;
+    return stats;
+}
+
+AudioLevelSnapshot OhosAudioDeviceModule::GetInputLevel() const
+{
+    return inputLevelMeter_.GetLevel();
+}
+
+AudioLevelSnapshot OhosAudioDeviceModule::GetOutputLevel() const
+{
+    return output_->GetLevel();
+}
+
+OhosAudioDeviceModule::CallbackStats OhosAudioDeviceModule::GetCallbackStats() const
+{
+    CallbackStats result;
+    if (auto stats = output_->GetCallbackStats()) {
+        result.playout = stats->GetSnapshot();
+    }
+
+    std::lock_guard<std::mutex> lock(mut_);
+    std::vector<std::shared_ptr<AudioInput>> inputs;
+    if (mixingInput_) {
+        result.mix = mixingInput_->GetCallbackStats()->GetSnapshot();
+        result.sources = mixingInput_->GetSourceStats();
+        inputs = mixingInput_->GetAudioInputs();
+    } else if (input_) {
+        inputs.push_back(input_);
+    }
+
+    for (const auto& input : inputs) {
+        if (auto stats = input->GetCallbackStats()) {
+            result.capture.push_back(stats->GetSnapshot());
+            result.capture.back().label = input->GetLabel();
+        }
+    }
+
+    return result;
+}
+
 void OhosAudioDeviceModule::RegisterInputObserver(AudioInput::Observer* obs)
 {
     RTC_DCHECK(obs);
@@ -407,9 +569,17 @@ int32_t OhosAudioDeviceModule::InitRecording()
         return 0;
     }
 
+    // inputs added or removed while recording are applied on this thread
+    recordingThread_.store(rtc::Thread::Current(), std::memory_order_release);
+
     {
         // Determine real input
         std::lock_guard<std::mutex> lock(mut_);
+        if (input_) {
+            input_->UnregisterObserver(this);
+        }
+
+        mixingInput_.reset();
         if (inputs_.empty()) {
             // Use default
             input_ = defaultInput_;
@@ -426,6 +596,7 @@ int32_t OhosAudioDeviceModule::InitRecording()
                 mixerInput->AddAudioInput(input);
             }
             input_ = mixerInput;
+            mixingInput_ = mixerInput;
         }
         input_->Init();
         input_->RegisterObserver(this);
@@ -542,6 +713,7 @@ int32_t OhosAudioDeviceModule::StopRecording()
     audioDeviceBuffer_->StopRecording();
     int32_t result = input_->StopRecording();
     RTC_DLOG(LS_INFO) << "output: " << result;
+    inputLevelMeter_.Reset();
 
     return result;
 }
@@ -816,6 +988,8 @@ int32_t OhosAudioDeviceModule::GetPlayoutUnderrunCount() const
     return output_->GetPlayoutUnderrunCount();
 }
 
+// AudioDeviceModule::Stats only has the playout fields of the webrtc stats, which the renderer fills from its telemetry.
+// The histograms, the capture side and the glitches do not fit in it, they are reported by GetCallbackStats().
 absl::optional<AudioDeviceModule::Stats> OhosAudioDeviceModule::GetStats() const
 {
     if (!initialized_) {
@@ -831,7 +1005,7 @@ void OhosAudioDeviceModule::OnAudioInputError(AudioInput* input, AudioErrorType
 
     std::lock_guard<std::mutex> lock(inputObsMutex_);
     for (auto& obs : inputObservers_) {
-        obs->OnAudioInputError(input_.get(), type, message);
+        obs->OnAudioInputError(input, type, message);
     }
 }
 
@@ -841,7 +1015,7 @@ void OhosAudioDeviceModule::OnAudioInputStateChange(AudioInput* input, AudioStat
 
     std::lock_guard<std::mutex> lock(inputObsMutex_);
     for (auto& obs : inputObservers_) {
-        obs->OnAudioInputStateChange(input_.get(), newState);
+        obs->OnAudioInputStateChange(input, newState);
     }
 }
 
@@ -850,13 +1024,39 @@ void OhosAudioDeviceModule::OnAudioInputDataReady(
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
-    inputAudioBuffer_->DeliverRecordedData(
-        rtc::MakeArrayView(static_cast<const int16_t*>(buffer), length / sizeof(int16_t)),
-        static_cast<int>(deleyUs / rtc::kNumMicrosecsPerMillisec));
+    const int32_t format = input->GetSampleFormat();
+    const size_t bytesPerSample = GetBytesPerSample(format);
+    if (bytesPerSample == 0) {
+        RTC_LOG(LS_ERROR) << "Unsupported sample format: " << format;
+        return;
+    }
+
+    auto samples = rtc::MakeArrayView(static_cast<const int16_t*>(buffer), length / bytesPerSample);
+    if (format != AUDIOSTREAM_SAMPLE_S16LE) {
+        // the only conversion on the way of the samples, the observers still get the native format
+        if (recordData_.size() < samples.size()) {
+            recordData_.resize(samples.size());
+        }
+        ConvertToS16(format, buffer, samples.size(), recordData_.data());
+        samples = rtc::MakeArrayView(static_cast<const int16_t*>(recordData_.data()), samples.size());
+    }
+
+    // The playout has a FineAudioBuffer of its own, so the one of the recording knows nothing about the playout
+    // delay. Pass the sum as the record delay, AudioDeviceBuffer only uses the total for the echo canceller.
+    uint16_t playoutDelayMs = 0;
+    if (output_->Playing()) {
+        output_->PlayoutDelay(&playoutDelayMs);
+    }
+    int32_t recordDelayMs = static_cast<int32_t>(deleyUs / rtc::kNumMicrosecsPerMillisec);
+    recordDelayMs_.store(recordDelayMs, std::memory_order_relaxed);
+    playoutDelayMs_.store(playoutDelayMs, std::memory_order_relaxed);
+
+    inputAudioBuffer_->DeliverRecordedData(samples, recordDelayMs + playoutDelayMs);
+    inputLevelMeter_.Process(samples.data(), samples.size(), input->GetSampleRate(), input->GetChannelCount());
 
     std::lock_guard<std::mutex> lock(inputObsMutex_);
     for (auto& obs : inputObservers_) {
-        obs->OnAudioInputDataReady(input_.get(), buffer, length, timestampUs, deleyUs);
+        obs->OnAudioInputDataReady(input, buffer, length, timestampUs, deleyUs);
     }
 }
 
@@ -899,9 +1099,16 @@ void NapiAudioDeviceModule::Init(Napi::Env env, Napi::Object exports)
                 kAttributeNameOnRendererError, napi_default, (void*)kEventNameRendererError),
             InstanceAccessor<&NapiAudioDeviceModule::GetEventHandler, &NapiAudioDeviceModule::SetEventHandler>(
                 kAttributeNameOnRendererStateChange, napi_default, (void*)kEventNameRendererStateChange),
+            InstanceAccessor<&NapiAudioDeviceModule::GetEventHandler, &NapiAudioDeviceModule::SetEventHandler>(
+                kAttributeNameOnAudioLevel, napi_default, (void*)kEventNameAudioLevel),
             InstanceMethod<&NapiAudioDeviceModule::SetSpeakerMute>(kMethodNameSetSpeakerMute),
             InstanceMethod<&NapiAudioDeviceModule::SetMicrophoneMute>(kMethodNameSetMicrophoneMute),
             InstanceMethod<&NapiAudioDeviceModule::SetNoiseSuppressorEnabled>(kMethodNameSetNoiseSuppressorEnabled),
+            InstanceMethod<&NapiAudioDeviceModule::GetDelayStats>(kMethodNameGetDelayStats),
+            InstanceMethod<&NapiAudioDeviceModule::SetSamplesEventOptions>(kMethodNameSetSamplesEventOptions),
+            InstanceMethod<&NapiAudioDeviceModule::GetSamplesEventStats>(kMethodNameGetSamplesEventStats),
+            InstanceMethod<&NapiAudioDeviceModule::GetAudioLevels>(kMethodNameGetAudioLevels),
+            InstanceMethod<&NapiAudioDeviceModule::GetCallbackStats>(kMethodNameGetCallbackStats),
             InstanceMethod<&NapiAudioDeviceModule::ToJson>(kMethodNameToJson),
             StaticMethod<&NapiAudioDeviceModule::isBuiltInAcousticEchoCancelerSupported>(
                 kMethodNameIsBuiltInAcousticEchoCancelerSupported),
@@ -913,6 +1120,47 @@ void NapiAudioDeviceModule::Init(Napi::Env env, Napi::Object exports)
     constructor_ = Persistent(func);
 }
 
+Object NewJsAudioLevel(Napi::Env env, const AudioLevelSnapshot& level)
+{
+    auto obj = Object::New(env);
+    obj.Set(kAttributeNameRms, Number::New(env, level.rms));
+    obj.Set(kAttributeNamePeak, Number::New(env, level.peak));
+    obj.Set(kAttributeNameVoiceActive, Boolean::New(env, level.voiceActive));
+    return obj;
+}
+
+Array NewJsHistogram(Napi::Env env, const std::vector<uint64_t>& buckets)
+{
+    auto array = Array::New(env, buckets.size());
+    for (uint32_t i = 0; i < buckets.size(); i++) {
+        array[i] = Number::New(env, buckets[i]);
+    }
+    return array;
+}
+
+Object NewJsCallbackStats(Napi::Env env, const AudioCallbackStats::Snapshot& stats)
+{
+    auto jsGlitches = Array::New(env, stats.recentGlitches.size());
+    for (uint32_t i = 0; i < stats.recentGlitches.size(); i++) {
+        const auto& glitch = stats.recentGlitches[i];
+        auto jsGlitch = Object::New(env);
+        jsGlitch.Set(kAttributeNameTimestamp, Number::New(env, glitch.timestampMs));
+        jsGlitch.Set(kAttributeNameType, String::New(env, GlitchTypeToString(glitch.type)));
+        jsGlitch.Set(kAttributeNameValue, Number::New(env, glitch.value));
+        jsGlitches[i] = jsGlitch;
+    }
+
+    auto obj = Object::New(env);
+    obj.Set(kAttributeNameLabel, String::New(env, stats.label));
+    obj.Set(kAttributeNameCallbackCount, Number::New(env, stats.callbackCount));
+    obj.Set(kAttributeNameIntervalHistogram, NewJsHistogram(env, stats.intervalHistogram));
+    obj.Set(kAttributeNameDurationHistogram, NewJsHistogram(env, stats.durationHistogram));
+    obj.Set(kAttributeNameFillHistogram, NewJsHistogram(env, stats.fillHistogram));
+    obj.Set(kAttributeNameGlitchCount, Number::New(env, stats.glitchCount));
+    obj.Set(kAttributeNameRecentGlitches, jsGlitches);
+    return obj;
+}
+
 bool GetOption(const Object& obj, const char* key, std::optional<int32_t>* valueOut)
 {
     if (obj.Has(key)) {
@@ -931,7 +1179,8 @@ bool GetOption(const Object& obj, const char* key, std::optional<bool>* valueOut
     return false;
 }
 
-NapiAudioDeviceModule::NapiAudioDeviceModule(const Napi::CallbackInfo& info) : ObjectWrap<NapiAudioDeviceModule>(info)
+NapiAudioDeviceModule::NapiAudioDeviceModule(const Napi::CallbackInfo& info)
+    : ObjectWrap<NapiAudioDeviceModule>(info), levelEventIntervalMs_(kDefaultAudioLevelIntervalMs)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
@@ -949,6 +1198,21 @@ NapiAudioDeviceModule::NapiAudioDeviceModule(const Napi::CallbackInfo& info) : O
         GetOption(options, kAttributeNameRendererUsage, &outputOptions.usage);
         GetOption(options, kAttributeNameUseLowLatency, &outputOptions.useLowLatency);
 
+        GetOption(options, kAttributeNameAudioBufferDuration, &inputOptions.bufferDuration);
+        GetOption(options, kAttributeNameAudioBufferDuration, &outputOptions.bufferDuration);
+        if (inputOptions.bufferDuration && *inputOptions.bufferDuration <= 0) {
+            NAPI_THROW_VOID(RangeError::New(info.Env(), "Invalid audio buffer duration"));
+        }
+
+        std::optional<int32_t> levelInterval;
+        GetOption(options, kAttributeNameAudioLevelInterval, &levelInterval);
+        if (levelInterval) {
+            if (*levelInterval <= 0) {
+                NAPI_THROW_VOID(RangeError::New(info.Env(), "Invalid audio level interval"));
+            }
+            levelEventIntervalMs_ = *levelInterval;
+        }
+
         if (options.Has(kAttributeNameUseStereoInput)) {
             bool useStereoInput = options.Get(kAttributeNameUseStereoInput).As<Boolean>().Value();
             inputOptions.channelCount = useStereoInput ? kAudioChannelCount_Stereo : kAudioChannelCount_Mono;
@@ -960,8 +1224,12 @@ NapiAudioDeviceModule::NapiAudioDeviceModule(const Napi::CallbackInfo& info) : O
         }
 
         if (options.Has(kAttributeNameAudioFormat)) {
-            // Ignore, always use AUDIOSTREAM_SAMPLE_S16LE
-            RTC_DLOG(LS_INFO) << "audioFormat: " << options.Get(kAttributeNameAudioFormat).As<Number>().Int32Value();
+            int32_t audioFormat = options.Get(kAttributeNameAudioFormat).As<Number>().Int32Value();
+            RTC_DLOG(LS_INFO) << "audioFormat: " << audioFormat;
+            if (!IsSupportedSampleFormat(audioFormat)) {
+                NAPI_THROW_VOID(Error::New(info.Env(), "Unsupported audio format"));
+            }
+            inputOptions.format = audioFormat;
         }
 
         if (options.Has(kAttributeNameUseHardwareAcousticEchoCanceler)) {
@@ -991,9 +1259,26 @@ NapiAudioDeviceModule::~NapiAudioDeviceModule()
 {
     RTC_DLOG(LS_INFO) << __FUNCTION__;
 
+    if (adm_) {
+        adm_->UnregisterInputObserver(this);
+        adm_->UnregisterOutputObserver(this);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     for (auto& handler : eventHandlers_) {
         handler.second.tsfn.Release();
     }
+    ReleaseSamplesPool();
+}
+
+void NapiAudioDeviceModule::ReleaseSamplesPool()
+{
+    if (samplesPool_) {
+        samplesDroppedCount_ += samplesPool_->GetDroppedCount();
+        samplesOverflowCount_ += samplesPool_->GetOverflowCount();
+        samplesPool_->Release();
+        samplesPool_ = nullptr;
+    }
 }
 
 Napi::Value NapiAudioDeviceModule::GetEventHandler(const Napi::CallbackInfo& info)
@@ -1072,6 +1357,121 @@ Napi::Value NapiAudioDeviceModule::SetNoiseSuppressorEnabled(const Napi::Callbac
     return Boolean::New(info.Env(), false);
 }
 
+Napi::Value NapiAudioDeviceModule::GetDelayStats(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto stats = adm_->GetDelayStats();
+
+    auto result = Object::New(info.Env());
+    result.Set(kAttributeNameRecordDelay, Number::New(info.Env(), stats.recordDelayMs));
+    result.Set(kAttributeNamePlayoutDelay, Number::New(info.Env(), stats.playoutDelayMs));
+    result.Set(kAttributeNameCombinedDelay, Number::New(info.Env(), stats.combinedDelayMs));
+
+    return result;
+}
+
+Napi::Value NapiAudioDeviceModule::SetSamplesEventOptions(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        NAPI_THROW(TypeError::New(info.Env(), "First argument is not Object"), info.Env().Undefined());
+    }
+
+    auto options = info[0].As<Object>();
+
+    std::optional<bool> pooled;
+    std::optional<int32_t> bufferCount;
+    std::optional<int32_t> interval;
+    std::optional<bool> manualRelease;
+    GetOption(options, kAttributeNamePooled, &pooled);
+    GetOption(options, kAttributeNameBufferCount, &bufferCount);
+    GetOption(options, kAttributeNameInterval, &interval);
+    GetOption(options, kAttributeNameManualRelease, &manualRelease);
+
+    if (bufferCount && *bufferCount <= 0) {
+        NAPI_THROW(RangeError::New(info.Env(), "Invalid buffer count"), info.Env().Undefined());
+    }
+    if (interval && *interval <= 0) {
+        NAPI_THROW(RangeError::New(info.Env(), "Invalid interval"), info.Env().Undefined());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReleaseSamplesPool();
+    if (pooled.value_or(false)) {
+        samplesPool_ = AudioSamplesPool::Create(
+            info.Env(), info.This().As<Object>(), kAttributeNameOnCapturerSamplesReady,
+            bufferCount.value_or(AudioSamplesPool::kDefaultBufferCount),
+            interval.value_or(AudioSamplesPool::kDefaultIntervalMs), manualRelease.value_or(false));
+    }
+
+    return info.Env().Undefined();
+}
+
+Napi::Value NapiAudioDeviceModule::GetSamplesEventStats(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t droppedCount = samplesDroppedCount_;
+    uint64_t overflowCount = samplesOverflowCount_;
+    if (samplesPool_) {
+        droppedCount += samplesPool_->GetDroppedCount();
+        overflowCount += samplesPool_->GetOverflowCount();
+    }
+
+    auto result = Object::New(info.Env());
+    result.Set(kAttributeNameDroppedCount, Number::New(info.Env(), droppedCount));
+    result.Set(kAttributeNameOverflowCount, Number::New(info.Env(), overflowCount));
+
+    return result;
+}
+
+Napi::Value NapiAudioDeviceModule::GetAudioLevels(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto result = Object::New(info.Env());
+    result.Set(kAttributeNameInput, NewJsAudioLevel(info.Env(), adm_->GetInputLevel()));
+    result.Set(kAttributeNameOutput, NewJsAudioLevel(info.Env(), adm_->GetOutputLevel()));
+
+    return result;
+}
+
+Napi::Value NapiAudioDeviceModule::GetCallbackStats(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto stats = adm_->GetCallbackStats();
+
+    auto jsCapture = Array::New(info.Env(), stats.capture.size());
+    for (uint32_t i = 0; i < stats.capture.size(); i++) {
+        jsCapture[i] = NewJsCallbackStats(info.Env(), stats.capture[i]);
+    }
+
+    auto jsSources = Array::New(info.Env(), stats.sources.size());
+    for (uint32_t i = 0; i < stats.sources.size(); i++) {
+        auto jsSource = Object::New(info.Env());
+        jsSource.Set(kAttributeNameLabel, String::New(info.Env(), stats.sources[i].label));
+        jsSource.Set(kAttributeNameUnderrunCount, Number::New(info.Env(), stats.sources[i].underruns));
+        jsSource.Set(kAttributeNameOverrunCount, Number::New(info.Env(), stats.sources[i].overruns));
+        jsSources[i] = jsSource;
+    }
+
+    auto result = Object::New(info.Env());
+    if (stats.playout) {
+        result.Set(kAttributeNamePlayout, NewJsCallbackStats(info.Env(), *stats.playout));
+    }
+    if (stats.mix) {
+        result.Set(kAttributeNameMix, NewJsCallbackStats(info.Env(), *stats.mix));
+    }
+    result.Set(kAttributeNameCapture, jsCapture);
+    result.Set(kAttributeNameSources, jsSources);
+
+    return result;
+}
+
 Napi::Value NapiAudioDeviceModule::ToJson(const Napi::CallbackInfo& info)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
@@ -1151,18 +1551,25 @@ void NapiAudioDeviceModule::OnAudioInputDataReady(
     AudioInput* input, void* buffer, int32_t length, int64_t timestampUs, int64_t deleyUs)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    PostLevelEvent();
+
     auto it = eventHandlers_.find(kEventNameCapturerSamplesReady);
     if (it == eventHandlers_.end()) {
         return;
     }
 
+    if (samplesPool_) {
+        samplesPool_->Write(input->GetSampleRate(), input->GetChannelCount(), input->GetSampleFormat(), buffer, length);
+        return;
+    }
+
     auto data = new rtc::CopyOnWriteBuffer((uint8_t*)buffer, length);
 
     auto& tsfn = it->second.tsfn;
     Reference<Napi::Value>* context = tsfn.GetContext();
     napi_status status =
         tsfn.NonBlockingCall([context, sampleRate = input->GetSampleRate(), channelCount = input->GetChannelCount(),
-                              data](Napi::Env env, Napi::Function jsCallback) {
+                              audioFormat = input->GetSampleFormat(), data](Napi::Env env, Napi::Function jsCallback) {
             auto arrayBuffer = ArrayBuffer::New(
                 env, static_cast<void*>(data->MutableData()), data->size(),
                 [](Napi::Env /*env*/, void* /*data*/, rtc::CopyOnWriteBuffer* hint) {
@@ -1173,7 +1580,7 @@ void NapiAudioDeviceModule::OnAudioInputDataReady(
 
             auto jsAudioSamples = Object::New(env);
             jsAudioSamples.Set("sampleRate", Number::New(env, sampleRate));
-            jsAudioSamples.Set("audioFormat", Number::New(env, AUDIOSTREAM_SAMPLE_S16LE));
+            jsAudioSamples.Set("audioFormat", Number::New(env, audioFormat));
             jsAudioSamples.Set("channelCount", Number::New(env, channelCount));
             jsAudioSamples.Set("data", arrayBuffer);
 
@@ -1181,6 +1588,36 @@ void NapiAudioDeviceModule::OnAudioInputDataReady(
             jsEvent.Set("samples", jsAudioSamples);
             jsCallback.Call(context ? context->Value() : env.Undefined(), {jsEvent});
         });
+    if (status != napi_ok) {
+        RTC_LOG(LS_ERROR) << " tsfn call error: " << status;
+        samplesDroppedCount_++;
+        delete data;
+    }
+}
+
+void NapiAudioDeviceModule::PostLevelEvent()
+{
+    auto it = eventHandlers_.find(kEventNameAudioLevel);
+    if (it == eventHandlers_.end()) {
+        return;
+    }
+
+    const int64_t nowMs = rtc::TimeMillis();
+    if (nowMs - lastLevelEventMs_ < levelEventIntervalMs_) {
+        return;
+    }
+    lastLevelEventMs_ = nowMs;
+
+    auto& tsfn = it->second.tsfn;
+    Reference<Napi::Value>* context = tsfn.GetContext();
+    napi_status status = tsfn.NonBlockingCall(
+        [context, inputLevel = adm_->GetInputLevel(),
+         outputLevel = adm_->GetOutputLevel()](Napi::Env env, Napi::Function jsCallback) {
+            auto jsEvent = Object::New(env);
+            jsEvent.Set(kAttributeNameInput, NewJsAudioLevel(env, inputLevel));
+            jsEvent.Set(kAttributeNameOutput, NewJsAudioLevel(env, outputLevel));
+            jsCallback.Call(context ? context->Value() : env.Undefined(), {jsEvent});
+        });
     if (status != napi_ok) {
         RTC_LOG(LS_ERROR) << " tsfn call error: " << status;
     }
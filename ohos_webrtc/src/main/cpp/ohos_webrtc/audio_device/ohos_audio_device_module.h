@@ -20,16 +20,20 @@
 #include <list>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "api/audio_options.h"
 #include "api/sequence_checker.h"
 #include "modules/audio_device/include/audio_device.h"
 #include "modules/audio_device/fine_audio_buffer.h"
+#include "rtc_base/thread.h"
 
 #include "napi.h"
 
 #include "audio_input.h"
 #include "audio_output.h"
+#include "audio_samples_pool.h"
+#include "mixing_audio_input.h"
 #include "ohos_local_audio_source.h"
 
 namespace webrtc {
@@ -43,6 +47,7 @@ public:
     OhosAudioDeviceModule(const OhosAudioDeviceModule&) = delete;
     OhosAudioDeviceModule& operator=(const OhosAudioDeviceModule&) = delete;
 
+    // Can be called while recording, the inputs are then mixed without restarting the recording.
     void AddAudioInput(std::shared_ptr<AudioInput> input);
     void RemoveAudioInput(std::shared_ptr<AudioInput> input);
 
@@ -56,6 +61,36 @@ public:
     void RegisterOutputObserver(AudioOutput::Observer* obs);
     void UnregisterOutputObserver(AudioOutput::Observer* obs);
 
+    struct DelayStats {
+        // from the capture of the newest sample to its delivery, of the last recorded buffer
+        int32_t recordDelayMs;
+        // from the request of the samples to their playout, of the last played buffer
+        int32_t playoutDelayMs;
+        // sum of the two one-way delays above, the render to capture delay the echo canceller is told about. Not a
+        // measurement of the acoustic path, the actual echo delay is estimated by the echo canceller itself.
+        int32_t combinedDelayMs;
+    };
+
+    DelayStats GetDelayStats() const;
+
+    // Levels of the samples last recorded and played, can be called on any thread.
+    AudioLevelSnapshot GetInputLevel() const;
+    AudioLevelSnapshot GetOutputLevel() const;
+
+    struct CallbackStats {
+        // of the renderer
+        absl::optional<AudioCallbackStats::Snapshot> playout;
+        // of the mixing, when the inputs are mixed
+        absl::optional<AudioCallbackStats::Snapshot> mix;
+        // of each recorded input which measures them
+        std::vector<AudioCallbackStats::Snapshot> capture;
+        // fifo counters of each input of the mixing
+        std::vector<MixingAudioInput::SourceStats> sources;
+    };
+
+    // Telemetry of the audio callbacks, can be called on any thread.
+    CallbackStats GetCallbackStats() const;
+
 protected:
     enum class InitStatus {
         OK = 0,
@@ -129,6 +164,10 @@ protected:
     int32_t GetPlayoutUnderrunCount() const override;
     absl::optional<Stats> GetStats() const override;
 
+    void PostUpdateRecordingInputs();
+    // Apply the inputs to the live recording.
+    void UpdateRecordingInputs();
+
     // AudioInput::Observer implementation.
     void OnAudioInputError(AudioInput* input, AudioErrorType type, const std::string& message) override;
     void OnAudioInputStateChange(AudioInput* input, AudioStateType newState) override;
@@ -151,6 +190,13 @@ private:
 
     std::unique_ptr<AudioDeviceBuffer> audioDeviceBuffer_;
     std::unique_ptr<FineAudioBuffer> inputAudioBuffer_;
+    // samples of the input converted to int16, accessed on the capture thread only
+    std::vector<int16_t> recordData_;
+
+    // measured on the capture thread
+    std::atomic<int32_t> recordDelayMs_{0};
+    std::atomic<int32_t> playoutDelayMs_{0};
+    AudioLevelMeter inputLevelMeter_;
 
     bool initialized_{false};
 
@@ -160,8 +206,12 @@ private:
     std::set<AudioOutput::Observer*> outputObservers_;
 
     std::shared_ptr<AudioInput> input_;
+    // same as input_ if it is a mix
+    std::shared_ptr<MixingAudioInput> mixingInput_;
     mutable std::mutex mut_;
     std::list<std::shared_ptr<AudioInput>> inputs_;
+    // the thread the recording is controlled on
+    std::atomic<rtc::Thread*> recordingThread_{nullptr};
 
     // Sets all recorded samples to zero if `microphoneMute_` is true, i.e., ensures that
     // the microphone is muted.
@@ -192,6 +242,11 @@ protected:
     Napi::Value SetSpeakerMute(const Napi::CallbackInfo& info);
     Napi::Value SetMicrophoneMute(const Napi::CallbackInfo& info);
     Napi::Value SetNoiseSuppressorEnabled(const Napi::CallbackInfo& info);
+    Napi::Value GetDelayStats(const Napi::CallbackInfo& info);
+    Napi::Value SetSamplesEventOptions(const Napi::CallbackInfo& info);
+    Napi::Value GetSamplesEventStats(const Napi::CallbackInfo& info);
+    Napi::Value GetAudioLevels(const Napi::CallbackInfo& info);
+    Napi::Value GetCallbackStats(const Napi::CallbackInfo& info);
     Napi::Value ToJson(const Napi::CallbackInfo& info);
 
     static Napi::Value isBuiltInAcousticEchoCancelerSupported(const Napi::CallbackInfo& info);
@@ -220,6 +275,17 @@ private:
 
     mutable std::mutex mutex_;
     std::map<std::string, EventHandler> eventHandlers_;
+    // delivers the samples event in pooled buffers when set
+    AudioSamplesPool* samplesPool_{};
+    // counters of the samples event, not including those of samplesPool_
+    uint64_t samplesDroppedCount_{0};
+    uint64_t samplesOverflowCount_{0};
+    // the level event is throttled to one per interval
+    int32_t levelEventIntervalMs_;
+    int64_t lastLevelEventMs_{0};
+
+    void ReleaseSamplesPool();
+    void PostLevelEvent();
 };
 
 rtc::scoped_refptr<OhosAudioDeviceModule> CreateDefaultAudioDeviceModule();
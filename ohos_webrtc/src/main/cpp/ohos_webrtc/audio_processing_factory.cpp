@@ -15,12 +15,56 @@
 
 #include "audio_processing_factory.h"
 
+#include <string>
+
 #include "rtc_base/logging.h"
 
 namespace webrtc {
 
 using namespace Napi;
 
+const char kAttributeNameEnabled[] = "enabled";
+const char kAttributeNamePipeline[] = "pipeline";
+const char kAttributeNameMaximumInternalProcessingRate[] = "maximumInternalProcessingRate";
+const char kAttributeNameMultiChannelRender[] = "multiChannelRender";
+const char kAttributeNameMultiChannelCapture[] = "multiChannelCapture";
+const char kAttributeNameCaptureDownmixMethod[] = "captureDownmixMethod";
+const char kAttributeNamePreAmplifier[] = "preAmplifier";
+const char kAttributeNameFixedGainFactor[] = "fixedGainFactor";
+const char kAttributeNameHighPassFilter[] = "highPassFilter";
+const char kAttributeNameApplyInFullBand[] = "applyInFullBand";
+const char kAttributeNameEchoCanceller[] = "echoCanceller";
+const char kAttributeNameMobileMode[] = "mobileMode";
+const char kAttributeNameEnforceHighPassFiltering[] = "enforceHighPassFiltering";
+const char kAttributeNameNoiseSuppression[] = "noiseSuppression";
+const char kAttributeNameLevel[] = "level";
+const char kAttributeNameTransientSuppression[] = "transientSuppression";
+const char kAttributeNameGainController1[] = "gainController1";
+const char kAttributeNameMode[] = "mode";
+const char kAttributeNameTargetLevelDbfs[] = "targetLevelDbfs";
+const char kAttributeNameCompressionGainDb[] = "compressionGainDb";
+const char kAttributeNameEnableLimiter[] = "enableLimiter";
+const char kAttributeNameGainController2[] = "gainController2";
+const char kAttributeNameInputVolumeController[] = "inputVolumeController";
+const char kAttributeNameAdaptiveDigital[] = "adaptiveDigital";
+const char kAttributeNameHeadroomDb[] = "headroomDb";
+const char kAttributeNameMaxGainDb[] = "maxGainDb";
+const char kAttributeNameInitialGainDb[] = "initialGainDb";
+const char kAttributeNameMaxGainChangeDbPerSecond[] = "maxGainChangeDbPerSecond";
+const char kAttributeNameMaxOutputNoiseLevelDbfs[] = "maxOutputNoiseLevelDbfs";
+const char kAttributeNameFixedDigital[] = "fixedDigital";
+const char kAttributeNameGainDb[] = "gainDb";
+
+const char kEnumDownmixMethodAverageChannels[] = "average-channels";
+const char kEnumDownmixMethodUseFirstChannel[] = "use-first-channel";
+const char kEnumNoiseSuppressionLevelLow[] = "low";
+const char kEnumNoiseSuppressionLevelModerate[] = "moderate";
+const char kEnumNoiseSuppressionLevelHigh[] = "high";
+const char kEnumNoiseSuppressionLevelVeryHigh[] = "very-high";
+const char kEnumGainController1ModeAdaptiveAnalog[] = "adaptive-analog";
+const char kEnumGainController1ModeAdaptiveDigital[] = "adaptive-digital";
+const char kEnumGainController1ModeFixedDigital[] = "fixed-digital";
+
 FunctionReference NapiAudioProcessing::constructor_;
 
 void NapiAudioProcessing::Init(Napi::Env env, Napi::Object exports)
@@ -30,6 +74,8 @@ void NapiAudioProcessing::Init(Napi::Env env, Napi::Object exports)
     Function func = DefineClass(
         env, kClassName,
         {
+            InstanceMethod<&NapiAudioProcessing::ApplyConfig>(kMethodNameApplyConfig),
+            InstanceMethod<&NapiAudioProcessing::GetConfig>(kMethodNameGetConfig),
             InstanceMethod<&NapiAudioProcessing::ToJson>(kMethodNameToJson),
         });
     exports.Set(kClassName, func);
@@ -37,7 +83,7 @@ void NapiAudioProcessing::Init(Napi::Env env, Napi::Object exports)
     constructor_ = Persistent(func);
 }
 
-Napi::Object NapiAudioProcessing::NewInstance(Napi::Env env, rtc::scoped_refptr<AudioProcessing> audioProcessing)
+Napi::Object NapiAudioProcessing::NewInstance(Napi::Env env, rtc::scoped_refptr<OhosAudioProcessing> audioProcessing)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
 
@@ -45,8 +91,8 @@ Napi::Object NapiAudioProcessing::NewInstance(Napi::Env env, rtc::scoped_refptr<
         NAPI_THROW(Error::New(env, "Invalid argument"), Object());
     }
 
-    auto external = External<AudioProcessing>::New(
-        env, audioProcessing.release(), [](Napi::Env /*env*/, AudioProcessing* apm) { apm->Release(); });
+    auto external = External<OhosAudioProcessing>::New(
+        env, audioProcessing.release(), [](Napi::Env /*env*/, OhosAudioProcessing* apm) { apm->Release(); });
 
     return constructor_.New({external});
 }
@@ -57,7 +103,7 @@ NapiAudioProcessing::NapiAudioProcessing(const Napi::CallbackInfo& info) : Objec
         NAPI_THROW_VOID(Error::New(info.Env(), "Invalid argument"));
     }
 
-    audioProcessing_ = info[0].As<External<AudioProcessing>>().Data();
+    audioProcessing_ = info[0].As<External<OhosAudioProcessing>>().Data();
 }
 
 rtc::scoped_refptr<AudioProcessing> NapiAudioProcessing::Get() const
@@ -65,6 +111,36 @@ rtc::scoped_refptr<AudioProcessing> NapiAudioProcessing::Get() const
     return audioProcessing_;
 }
 
+Napi::Value NapiAudioProcessing::ApplyConfig(const Napi::CallbackInfo& info)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (info.Length() == 0 || !info[0].IsObject()) {
+        NAPI_THROW(TypeError::New(info.Env(), "First argument is not Object"), info.Env().Undefined());
+    }
+
+    // start from the current config, which includes the audio options of the sources applied by the voice engine
+    auto jsConfig = info[0].As<Object>();
+    auto config = audioProcessing_->GetConfig();
+    if (!JsToNativeAudioProcessingConfig(jsConfig, config)) {
+        NAPI_THROW(TypeError::New(info.Env(), "Invalid config"), info.Env().Undefined());
+    }
+
+    audioProcessing_->ApplyUserConfig(config, GetAudioProcessingUserConfigFields(jsConfig));
+
+    return info.Env().Undefined();
+}
+
+Napi::Value NapiAudioProcessing::GetConfig(const Napi::CallbackInfo& info)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto jsConfig = Object::New(info.Env());
+    NativeToJsAudioProcessingConfig(audioProcessing_->GetConfig(), jsConfig);
+
+    return jsConfig;
+}
+
 Napi::Value NapiAudioProcessing::ToJson(const Napi::CallbackInfo& info)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
@@ -104,13 +180,16 @@ Napi::Value NapiAudioProcessingFactory::Create(const Napi::CallbackInfo& info)
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
 
     AudioProcessing::Config apmConfig;
+    uint32_t userFields = OhosAudioProcessing::kUserConfigFieldNone;
     if (info.Length() > 0 && info[0].IsObject()) {
-        auto jsOptions = info[0].As<Object>();
-        (void)jsOptions;
-        // nothing to do
+        auto jsConfig = info[0].As<Object>();
+        if (!JsToNativeAudioProcessingConfig(jsConfig, apmConfig)) {
+            NAPI_THROW(TypeError::New(info.Env(), "Invalid config"), info.Env().Undefined());
+        }
+        userFields = GetAudioProcessingUserConfigFields(jsConfig);
     }
 
-    return NapiAudioProcessing::NewInstance(info.Env(), AudioProcessingBuilder().SetConfig(apmConfig).Create());
+    return NapiAudioProcessing::NewInstance(info.Env(), OhosAudioProcessing::Create(apmConfig, userFields));
 }
 
 Napi::Value NapiAudioProcessingFactory::ToJson(const Napi::CallbackInfo& info)
@@ -125,4 +204,359 @@ Napi::Value NapiAudioProcessingFactory::ToJson(const Napi::CallbackInfo& info)
     return json;
 }
 
+namespace {
+
+// Read an optional member of a js object, return false if it has a wrong type.
+bool GetMember(const Object& js, const char* key, bool& value)
+{
+    if (!js.Has(key)) {
+        return true;
+    }
+
+    auto jsValue = js.Get(key);
+    if (!jsValue.IsBoolean()) {
+        RTC_LOG(LS_WARNING) << key << " is not boolean";
+        return false;
+    }
+
+    value = jsValue.As<Boolean>().Value();
+    return true;
+}
+
+bool GetMember(const Object& js, const char* key, int& value)
+{
+    if (!js.Has(key)) {
+        return true;
+    }
+
+    auto jsValue = js.Get(key);
+    if (!jsValue.IsNumber()) {
+        RTC_LOG(LS_WARNING) << key << " is not number";
+        return false;
+    }
+
+    value = jsValue.As<Number>().Int32Value();
+    return true;
+}
+
+bool GetMember(const Object& js, const char* key, float& value)
+{
+    if (!js.Has(key)) {
+        return true;
+    }
+
+    auto jsValue = js.Get(key);
+    if (!jsValue.IsNumber()) {
+        RTC_LOG(LS_WARNING) << key << " is not number";
+        return false;
+    }
+
+    value = jsValue.As<Number>().FloatValue();
+    return true;
+}
+
+bool GetMember(const Object& js, const char* key, Object& value)
+{
+    if (!js.Has(key)) {
+        return true;
+    }
+
+    auto jsValue = js.Get(key);
+    if (!jsValue.IsObject()) {
+        RTC_LOG(LS_WARNING) << key << " is not object";
+        return false;
+    }
+
+    value = jsValue.As<Object>();
+    return true;
+}
+
+bool GetMember(const Object& js, const char* key, std::string& value)
+{
+    if (!js.Has(key)) {
+        return true;
+    }
+
+    auto jsValue = js.Get(key);
+    if (!jsValue.IsString()) {
+        RTC_LOG(LS_WARNING) << key << " is not string";
+        return false;
+    }
+
+    value = jsValue.As<String>().Utf8Value();
+    return true;
+}
+
+bool JsToNativePipeline(const Object& js, AudioProcessing::Config::Pipeline& pipeline)
+{
+    std::string downmixMethod;
+    bool ok = GetMember(js, kAttributeNameMaximumInternalProcessingRate, pipeline.maximum_internal_processing_rate) &&
+              GetMember(js, kAttributeNameMultiChannelRender, pipeline.multi_channel_render) &&
+              GetMember(js, kAttributeNameMultiChannelCapture, pipeline.multi_channel_capture) &&
+              GetMember(js, kAttributeNameCaptureDownmixMethod, downmixMethod);
+    if (!ok) {
+        return false;
+    }
+
+    using DownmixMethod = AudioProcessing::Config::Pipeline::DownmixMethod;
+    if (downmixMethod == kEnumDownmixMethodAverageChannels) {
+        pipeline.capture_downmix_method = DownmixMethod::kAverageChannels;
+    } else if (downmixMethod == kEnumDownmixMethodUseFirstChannel) {
+        pipeline.capture_downmix_method = DownmixMethod::kUseFirstChannel;
+    } else if (!downmixMethod.empty()) {
+        RTC_LOG(LS_WARNING) << "Invalid captureDownmixMethod";
+        return false;
+    }
+
+    return true;
+}
+
+bool JsToNativeNoiseSuppression(const Object& js, AudioProcessing::Config::NoiseSuppression& noiseSuppression)
+{
+    std::string level;
+    if (!GetMember(js, kAttributeNameEnabled, noiseSuppression.enabled) ||
+        !GetMember(js, kAttributeNameLevel, level))
+    {
+        return false;
+    }
+
+    using Level = AudioProcessing::Config::NoiseSuppression::Level;
+    if (level == kEnumNoiseSuppressionLevelLow) {
+        noiseSuppression.level = Level::kLow;
+    } else if (level == kEnumNoiseSuppressionLevelModerate) {
+        noiseSuppression.level = Level::kModerate;
+    } else if (level == kEnumNoiseSuppressionLevelHigh) {
+        noiseSuppression.level = Level::kHigh;
+    } else if (level == kEnumNoiseSuppressionLevelVeryHigh) {
+        noiseSuppression.level = Level::kVeryHigh;
+    } else if (!level.empty()) {
+        RTC_LOG(LS_WARNING) << "Invalid noise suppression level";
+        return false;
+    }
+
+    return true;
+}
+
+bool JsToNativeGainController1(const Object& js, AudioProcessing::Config::GainController1& gainController)
+{
+    std::string mode;
+    bool ok = GetMember(js, kAttributeNameEnabled, gainController.enabled) &&
+              GetMember(js, kAttributeNameMode, mode) &&
+              GetMember(js, kAttributeNameTargetLevelDbfs, gainController.target_level_dbfs) &&
+              GetMember(js, kAttributeNameCompressionGainDb, gainController.compression_gain_db) &&
+              GetMember(js, kAttributeNameEnableLimiter, gainController.enable_limiter);
+    if (!ok) {
+        return false;
+    }
+
+    using Mode = AudioProcessing::Config::GainController1::Mode;
+    if (mode == kEnumGainController1ModeAdaptiveAnalog) {
+        gainController.mode = Mode::kAdaptiveAnalog;
+    } else if (mode == kEnumGainController1ModeAdaptiveDigital) {
+        gainController.mode = Mode::kAdaptiveDigital;
+    } else if (mode == kEnumGainController1ModeFixedDigital) {
+        gainController.mode = Mode::kFixedDigital;
+    } else if (!mode.empty()) {
+        RTC_LOG(LS_WARNING) << "Invalid gain controller mode";
+        return false;
+    }
+
+    return true;
+}
+
+bool JsToNativeGainController2(const Object& js, AudioProcessing::Config::GainController2& gainController)
+{
+    auto jsInputVolumeController = Object::New(js.Env());
+    auto jsAdaptiveDigital = Object::New(js.Env());
+    auto jsFixedDigital = Object::New(js.Env());
+    auto& adaptiveDigital = gainController.adaptive_digital;
+
+    return GetMember(js, kAttributeNameEnabled, gainController.enabled) &&
+           GetMember(js, kAttributeNameInputVolumeController, jsInputVolumeController) &&
+           GetMember(js, kAttributeNameAdaptiveDigital, jsAdaptiveDigital) &&
+           GetMember(js, kAttributeNameFixedDigital, jsFixedDigital) &&
+           GetMember(jsInputVolumeController, kAttributeNameEnabled, gainController.input_volume_controller.enabled) &&
+           GetMember(jsAdaptiveDigital, kAttributeNameEnabled, adaptiveDigital.enabled) &&
+           GetMember(jsAdaptiveDigital, kAttributeNameHeadroomDb, adaptiveDigital.headroom_db) &&
+           GetMember(jsAdaptiveDigital, kAttributeNameMaxGainDb, adaptiveDigital.max_gain_db) &&
+           GetMember(jsAdaptiveDigital, kAttributeNameInitialGainDb, adaptiveDigital.initial_gain_db) &&
+           GetMember(
+               jsAdaptiveDigital, kAttributeNameMaxGainChangeDbPerSecond,
+               adaptiveDigital.max_gain_change_db_per_second) &&
+           GetMember(
+               jsAdaptiveDigital, kAttributeNameMaxOutputNoiseLevelDbfs, adaptiveDigital.max_output_noise_level_dbfs) &&
+           GetMember(jsFixedDigital, kAttributeNameGainDb, gainController.fixed_digital.gain_db);
+}
+
+const char* DownmixMethodToString(AudioProcessing::Config::Pipeline::DownmixMethod method)
+{
+    switch (method) {
+        case AudioProcessing::Config::Pipeline::DownmixMethod::kUseFirstChannel:
+            return kEnumDownmixMethodUseFirstChannel;
+        case AudioProcessing::Config::Pipeline::DownmixMethod::kAverageChannels:
+        default:
+            return kEnumDownmixMethodAverageChannels;
+    }
+}
+
+const char* NoiseSuppressionLevelToString(AudioProcessing::Config::NoiseSuppression::Level level)
+{
+    switch (level) {
+        case AudioProcessing::Config::NoiseSuppression::kLow:
+            return kEnumNoiseSuppressionLevelLow;
+        case AudioProcessing::Config::NoiseSuppression::kHigh:
+            return kEnumNoiseSuppressionLevelHigh;
+        case AudioProcessing::Config::NoiseSuppression::kVeryHigh:
+            return kEnumNoiseSuppressionLevelVeryHigh;
+        case AudioProcessing::Config::NoiseSuppression::kModerate:
+        default:
+            return kEnumNoiseSuppressionLevelModerate;
+    }
+}
+
+const char* GainController1ModeToString(AudioProcessing::Config::GainController1::Mode mode)
+{
+    switch (mode) {
+        case AudioProcessing::Config::GainController1::kAdaptiveDigital:
+            return kEnumGainController1ModeAdaptiveDigital;
+        case AudioProcessing::Config::GainController1::kFixedDigital:
+            return kEnumGainController1ModeFixedDigital;
+        case AudioProcessing::Config::GainController1::kAdaptiveAnalog:
+        default:
+            return kEnumGainController1ModeAdaptiveAnalog;
+    }
+}
+
+} // namespace
+
+bool JsToNativeAudioProcessingConfig(const Napi::Object& jsConfig, AudioProcessing::Config& config)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    Napi::Env env = jsConfig.Env();
+    auto jsPipeline = Object::New(env);
+    auto jsPreAmplifier = Object::New(env);
+    auto jsHighPassFilter = Object::New(env);
+    auto jsEchoCanceller = Object::New(env);
+    auto jsNoiseSuppression = Object::New(env);
+    auto jsTransientSuppression = Object::New(env);
+    auto jsGainController1 = Object::New(env);
+    auto jsGainController2 = Object::New(env);
+
+    bool ok = GetMember(jsConfig, kAttributeNamePipeline, jsPipeline) &&
+              GetMember(jsConfig, kAttributeNamePreAmplifier, jsPreAmplifier) &&
+              GetMember(jsConfig, kAttributeNameHighPassFilter, jsHighPassFilter) &&
+              GetMember(jsConfig, kAttributeNameEchoCanceller, jsEchoCanceller) &&
+              GetMember(jsConfig, kAttributeNameNoiseSuppression, jsNoiseSuppression) &&
+              GetMember(jsConfig, kAttributeNameTransientSuppression, jsTransientSuppression) &&
+              GetMember(jsConfig, kAttributeNameGainController1, jsGainController1) &&
+              GetMember(jsConfig, kAttributeNameGainController2, jsGainController2);
+    if (!ok) {
+        return false;
+    }
+
+    return JsToNativePipeline(jsPipeline, config.pipeline) &&
+           GetMember(jsPreAmplifier, kAttributeNameEnabled, config.pre_amplifier.enabled) &&
+           GetMember(jsPreAmplifier, kAttributeNameFixedGainFactor, config.pre_amplifier.fixed_gain_factor) &&
+           GetMember(jsHighPassFilter, kAttributeNameEnabled, config.high_pass_filter.enabled) &&
+           GetMember(jsHighPassFilter, kAttributeNameApplyInFullBand, config.high_pass_filter.apply_in_full_band) &&
+           GetMember(jsEchoCanceller, kAttributeNameEnabled, config.echo_canceller.enabled) &&
+           GetMember(jsEchoCanceller, kAttributeNameMobileMode, config.echo_canceller.mobile_mode) &&
+           GetMember(
+               jsEchoCanceller, kAttributeNameEnforceHighPassFiltering,
+               config.echo_canceller.enforce_high_pass_filtering) &&
+           JsToNativeNoiseSuppression(jsNoiseSuppression, config.noise_suppression) &&
+           GetMember(jsTransientSuppression, kAttributeNameEnabled, config.transient_suppression.enabled) &&
+           JsToNativeGainController1(jsGainController1, config.gain_controller1) &&
+           JsToNativeGainController2(jsGainController2, config.gain_controller2);
+}
+
+uint32_t GetAudioProcessingUserConfigFields(const Napi::Object& jsConfig)
+{
+    uint32_t fields = OhosAudioProcessing::kUserConfigFieldNone;
+    if (jsConfig.Has(kAttributeNameHighPassFilter)) {
+        fields |= OhosAudioProcessing::kUserConfigFieldHighPassFilter;
+    }
+    if (jsConfig.Has(kAttributeNameEchoCanceller)) {
+        fields |= OhosAudioProcessing::kUserConfigFieldEchoCanceller;
+    }
+    if (jsConfig.Has(kAttributeNameNoiseSuppression)) {
+        fields |= OhosAudioProcessing::kUserConfigFieldNoiseSuppression;
+    }
+    if (jsConfig.Has(kAttributeNameGainController1)) {
+        fields |= OhosAudioProcessing::kUserConfigFieldGainController1;
+    }
+    return fields;
+}
+
+bool NativeToJsAudioProcessingConfig(const AudioProcessing::Config& config, Napi::Object& jsConfig)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    Napi::Env env = jsConfig.Env();
+
+    auto jsPipeline = Object::New(env);
+    jsPipeline.Set(kAttributeNameMaximumInternalProcessingRate, config.pipeline.maximum_internal_processing_rate);
+    jsPipeline.Set(kAttributeNameMultiChannelRender, config.pipeline.multi_channel_render);
+    jsPipeline.Set(kAttributeNameMultiChannelCapture, config.pipeline.multi_channel_capture);
+    jsPipeline.Set(kAttributeNameCaptureDownmixMethod, DownmixMethodToString(config.pipeline.capture_downmix_method));
+    jsConfig.Set(kAttributeNamePipeline, jsPipeline);
+
+    auto jsPreAmplifier = Object::New(env);
+    jsPreAmplifier.Set(kAttributeNameEnabled, config.pre_amplifier.enabled);
+    jsPreAmplifier.Set(kAttributeNameFixedGainFactor, config.pre_amplifier.fixed_gain_factor);
+    jsConfig.Set(kAttributeNamePreAmplifier, jsPreAmplifier);
+
+    auto jsHighPassFilter = Object::New(env);
+    jsHighPassFilter.Set(kAttributeNameEnabled, config.high_pass_filter.enabled);
+    jsHighPassFilter.Set(kAttributeNameApplyInFullBand, config.high_pass_filter.apply_in_full_band);
+    jsConfig.Set(kAttributeNameHighPassFilter, jsHighPassFilter);
+
+    auto jsEchoCanceller = Object::New(env);
+    jsEchoCanceller.Set(kAttributeNameEnabled, config.echo_canceller.enabled);
+    jsEchoCanceller.Set(kAttributeNameMobileMode, config.echo_canceller.mobile_mode);
+    jsEchoCanceller.Set(kAttributeNameEnforceHighPassFiltering, config.echo_canceller.enforce_high_pass_filtering);
+    jsConfig.Set(kAttributeNameEchoCanceller, jsEchoCanceller);
+
+    auto jsNoiseSuppression = Object::New(env);
+    jsNoiseSuppression.Set(kAttributeNameEnabled, config.noise_suppression.enabled);
+    jsNoiseSuppression.Set(kAttributeNameLevel, NoiseSuppressionLevelToString(config.noise_suppression.level));
+    jsConfig.Set(kAttributeNameNoiseSuppression, jsNoiseSuppression);
+
+    auto jsTransientSuppression = Object::New(env);
+    jsTransientSuppression.Set(kAttributeNameEnabled, config.transient_suppression.enabled);
+    jsConfig.Set(kAttributeNameTransientSuppression, jsTransientSuppression);
+
+    auto jsGainController1 = Object::New(env);
+    jsGainController1.Set(kAttributeNameEnabled, config.gain_controller1.enabled);
+    jsGainController1.Set(kAttributeNameMode, GainController1ModeToString(config.gain_controller1.mode));
+    jsGainController1.Set(kAttributeNameTargetLevelDbfs, config.gain_controller1.target_level_dbfs);
+    jsGainController1.Set(kAttributeNameCompressionGainDb, config.gain_controller1.compression_gain_db);
+    jsGainController1.Set(kAttributeNameEnableLimiter, config.gain_controller1.enable_limiter);
+    jsConfig.Set(kAttributeNameGainController1, jsGainController1);
+
+    const auto& gainController2 = config.gain_controller2;
+    auto jsInputVolumeController = Object::New(env);
+    jsInputVolumeController.Set(kAttributeNameEnabled, gainController2.input_volume_controller.enabled);
+    auto jsAdaptiveDigital = Object::New(env);
+    jsAdaptiveDigital.Set(kAttributeNameEnabled, gainController2.adaptive_digital.enabled);
+    jsAdaptiveDigital.Set(kAttributeNameHeadroomDb, gainController2.adaptive_digital.headroom_db);
+    jsAdaptiveDigital.Set(kAttributeNameMaxGainDb, gainController2.adaptive_digital.max_gain_db);
+    jsAdaptiveDigital.Set(kAttributeNameInitialGainDb, gainController2.adaptive_digital.initial_gain_db);
+    jsAdaptiveDigital.Set(
+        kAttributeNameMaxGainChangeDbPerSecond, gainController2.adaptive_digital.max_gain_change_db_per_second);
+    jsAdaptiveDigital.Set(
+        kAttributeNameMaxOutputNoiseLevelDbfs, gainController2.adaptive_digital.max_output_noise_level_dbfs);
+    auto jsFixedDigital = Object::New(env);
+    jsFixedDigital.Set(kAttributeNameGainDb, gainController2.fixed_digital.gain_db);
+    auto jsGainController2 = Object::New(env);
+    jsGainController2.Set(kAttributeNameEnabled, gainController2.enabled);
+    jsGainController2.Set(kAttributeNameInputVolumeController, jsInputVolumeController);
+    jsGainController2.Set(kAttributeNameAdaptiveDigital, jsAdaptiveDigital);
+    jsGainController2.Set(kAttributeNameFixedDigital, jsFixedDigital);
+    jsConfig.Set(kAttributeNameGainController2, jsGainController2);
+
+    return true;
+}
+
 } // namespace webrtc
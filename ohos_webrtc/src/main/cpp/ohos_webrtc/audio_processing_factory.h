@@ -16,6 +16,7 @@
 #ifndef WEBRTC_AUDIO_PROCESSING_FACTORY_H
 #define WEBRTC_AUDIO_PROCESSING_FACTORY_H
 
+#include "ohos_audio_processing.h"
 #include "utils/marcos.h"
 
 #include "modules/audio_processing/include/audio_processing.h"
@@ -27,11 +28,13 @@ namespace webrtc {
 class NapiAudioProcessing : public Napi::ObjectWrap<NapiAudioProcessing> {
 public:
     NAPI_CLASS_NAME_DECLARE(AudioProcessing);
+    NAPI_METHOD_NAME_DECLARE(ApplyConfig, applyConfig);
+    NAPI_METHOD_NAME_DECLARE(GetConfig, getConfig);
     NAPI_METHOD_NAME_DECLARE(ToJson, toJSON);
 
     static void Init(Napi::Env env, Napi::Object exports);
 
-    static Napi::Object NewInstance(Napi::Env env, rtc::scoped_refptr<AudioProcessing> audioProcessing);
+    static Napi::Object NewInstance(Napi::Env env, rtc::scoped_refptr<OhosAudioProcessing> audioProcessing);
 
     rtc::scoped_refptr<AudioProcessing> Get() const;
 
@@ -39,12 +42,14 @@ protected:
     friend class ObjectWrap;
     explicit NapiAudioProcessing(const Napi::CallbackInfo& info);
 
+    Napi::Value ApplyConfig(const Napi::CallbackInfo& info);
+    Napi::Value GetConfig(const Napi::CallbackInfo& info);
     Napi::Value ToJson(const Napi::CallbackInfo& info);
 
 private:
     static Napi::FunctionReference constructor_;
 
-    rtc::scoped_refptr<AudioProcessing> audioProcessing_;
+    rtc::scoped_refptr<OhosAudioProcessing> audioProcessing_;
 };
 
 class NapiAudioProcessingFactory : public Napi::ObjectWrap<NapiAudioProcessingFactory> {
@@ -66,6 +71,14 @@ private:
     static Napi::FunctionReference constructor_;
 };
 
+// Fields missing in the js object keep their value in the native config.
+bool JsToNativeAudioProcessingConfig(const Napi::Object& jsConfig, AudioProcessing::Config& config);
+
+// The groups of OhosAudioProcessing::UserConfigField present in the js object.
+uint32_t GetAudioProcessingUserConfigFields(const Napi::Object& jsConfig);
+
+bool NativeToJsAudioProcessingConfig(const AudioProcessing::Config& config, Napi::Object& jsConfig);
+
 } // namespace webrtc
 
 #endif // WEBRTC_AUDIO_PROCESSING_FACTORY_H
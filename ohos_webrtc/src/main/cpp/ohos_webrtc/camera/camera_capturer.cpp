@@ -315,8 +315,10 @@ void CameraCapturer::OnFrameAvailable(
 
     // Undo the mirror that the OS "helps" us with.
     // Also, undo camera orientation, we report it as rotation instead.
-    if (buffer->type() == VideoFrameBuffer::Type::kNative) {
-        auto textureBuffer = static_cast<TextureBuffer*>(buffer.get());
+    // native frames may also be backed by a native buffer, which is not transformed
+    auto textureBuffer =
+        buffer->type() == VideoFrameBuffer::Type::kNative ? dynamic_cast<TextureBuffer*>(buffer.get()) : nullptr;
+    if (textureBuffer) {
 
         Matrix transformMatrix;
         // Perform mirror and rotation around (0.5, 0.5) since that is the center of the texture.
@@ -328,7 +330,8 @@ void CameraCapturer::OnFrameAvailable(
         Matrix newMatrix = textureBuffer->GetTransformMatrix();
         newMatrix.PreConcat(transformMatrix);
         buffer = TextureBuffer::Create(
-            textureBuffer->GetTexture(), textureBuffer->width(), textureBuffer->height(), newMatrix);
+            textureBuffer->GetTexture(), textureBuffer->GetUnscaledWidth(), textureBuffer->GetUnscaledHeight(),
+            textureBuffer->width(), textureBuffer->height(), newMatrix);
     }
 
     UNUSED std::lock_guard<std::mutex> lock(obsMutex_);
@@ -14,8 +14,11 @@
  */
 
 #include "data_channel.h"
+#include "data_channel_writer.h"
+#include "peer_connection_factory.h"
 #include "utils/marcos.h"
 
+#include "media/sctp/sctp_transport_internal.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
@@ -43,6 +46,8 @@ const char kAttributeNameReadyState[] = "readyState";
 const char kAttributeNameBufferedAmount[] = "bufferedAmount";
 const char kAttributeNameBufferedAmountLowThreshold[] = "bufferedAmountLowThreshold";
 const char kAttributeNameBinaryType[] = "binaryType";
+const char kAttributeNameReceivedBytesCopied[] = "receivedBytesCopied";
+const char kAttributeNameCoalescedEventCount[] = "coalescedEventCount";
 const char kAttributeNameOnBufferedAmountLow[] = "onbufferedamountlow";
 const char kAttributeNameOnClose[] = "onclose";
 const char kAttributeNameOnClosing[] = "onclosing";
@@ -52,6 +57,8 @@ const char kAttributeNameOnError[] = "onerror";
 
 const char kMethodNameClose[] = "close";
 const char kMethodNameSend[] = "send";
+const char kMethodNameSendMany[] = "sendMany";
+const char kMethodNameCreateWriter[] = "createWriter";
 const char kMethodNameToJson[] = "toJSON";
 
 const char kEventNameBufferedAmountLow[] = "bufferedamountlow";
@@ -89,8 +96,8 @@ void DataChannelObserverTemp::OnMessage(const DataBuffer& buffer)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
 
-    Enqueue(
-        CallbackEvent<NapiDataChannel>::Create([buffer](NapiDataChannel& channel) { channel.HandleMessage(buffer); }));
+    Enqueue(CallbackEvent<NapiDataChannel>::Create(
+        [buffer](NapiDataChannel& channel) mutable { channel.HandleMessage(std::move(buffer)); }));
 }
 
 void DataChannelObserverTemp::OnBufferedAmountChange(uint64_t sentDataSize)
@@ -123,6 +130,8 @@ void NapiDataChannel::Init(Napi::Env env, Napi::Object exports)
                 kAttributeNameBufferedAmountLowThreshold),
             InstanceAccessor<&NapiDataChannel::GetBinaryType, &NapiDataChannel::SetBinaryType>(
                 kAttributeNameBinaryType),
+            InstanceAccessor<&NapiDataChannel::GetReceivedBytesCopied>(kAttributeNameReceivedBytesCopied),
+            InstanceAccessor<&NapiDataChannel::GetCoalescedEventCount>(kAttributeNameCoalescedEventCount),
             InstanceAccessor<&NapiDataChannel::GetEventHandler, &NapiDataChannel::SetEventHandler>(
                 kAttributeNameOnBufferedAmountLow, napi_default, (void*)kEventNameBufferedAmountLow),
             InstanceAccessor<&NapiDataChannel::GetEventHandler, &NapiDataChannel::SetEventHandler>(
@@ -137,6 +146,8 @@ void NapiDataChannel::Init(Napi::Env env, Napi::Object exports)
                 kAttributeNameOnError, napi_default, (void*)kEventNameError),
             InstanceMethod<&NapiDataChannel::Close>(kMethodNameClose),
             InstanceMethod<&NapiDataChannel::Send>(kMethodNameSend),
+            InstanceMethod<&NapiDataChannel::SendMany>(kMethodNameSendMany),
+            InstanceMethod<&NapiDataChannel::CreateWriter>(kMethodNameCreateWriter),
             InstanceMethod<&NapiDataChannel::ToJson>(kMethodNameToJson),
         });
     exports.Set(kClassName, func);
@@ -144,12 +155,21 @@ void NapiDataChannel::Init(Napi::Env env, Napi::Object exports)
     constructor_ = Persistent(func);
 }
 
-Napi::Object NapiDataChannel::NewInstance(Napi::Env env, std::unique_ptr<DataChannelObserverTemp> observer)
+Napi::Object NapiDataChannel::NewInstance(
+    std::shared_ptr<PeerConnectionFactoryWrapper> factory, rtc::scoped_refptr<PeerConnectionInterface> pc,
+    std::unique_ptr<DataChannelObserverTemp> observer)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
 
+    auto env = constructor_.Env();
+    if (!factory || !pc || !observer) {
+        NAPI_THROW(Error::New(env, "Invalid argument"), Object());
+    }
+
+    auto externalFactory = External<std::shared_ptr<PeerConnectionFactoryWrapper>>::New(env, &factory);
+    auto externalPc = External<rtc::scoped_refptr<PeerConnectionInterface>>::New(env, &pc);
     auto externalObserver = External<DataChannelObserverTemp>::New(env, observer.release());
-    return constructor_.New({externalObserver});
+    return constructor_.New({externalFactory, externalPc, externalObserver});
 }
 
 NapiDataChannel::NapiDataChannel(const CallbackInfo& info)
@@ -161,11 +181,14 @@ NapiDataChannel::NapiDataChannel(const CallbackInfo& info)
         NAPI_THROW_VOID(TypeError::New(info.Env(), "Use the new operator to construct the RTCDataChannel"));
     }
 
-    if (info.Length() < 1 || !info[0].IsExternal()) {
+    if (info.Length() < 3 || !info[0].IsExternal() || !info[1].IsExternal() || !info[2].IsExternal()) {
         NAPI_THROW_VOID(TypeError::New(info.Env(), "Invalid argument"));
     }
 
-    auto observer = std::unique_ptr<DataChannelObserverTemp>(info[0].As<External<DataChannelObserverTemp>>().Data());
+    factory_ = *info[0].As<External<std::shared_ptr<PeerConnectionFactoryWrapper>>>().Data();
+    pc_ = *info[1].As<External<rtc::scoped_refptr<PeerConnectionInterface>>>().Data();
+
+    auto observer = std::unique_ptr<DataChannelObserverTemp>(info[2].As<External<DataChannelObserverTemp>>().Data());
     dataChannel_ = observer->Get();
     dataChannel_->RegisterObserver(this);
 
@@ -322,6 +345,20 @@ void NapiDataChannel::SetBinaryType(const Napi::CallbackInfo& info, const Napi::
     binaryType_ = binaryType;
 }
 
+// readonly receivedBytesCopied : number;
+Napi::Value NapiDataChannel::GetReceivedBytesCopied(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), receivedBytesCopied_.load());
+}
+
+// readonly coalescedEventCount : number;
+Napi::Value NapiDataChannel::GetCoalescedEventCount(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), NapiEventTarget::GetCoalescedEventCount());
+}
+
 Napi::Value NapiDataChannel::GetEventHandler(const Napi::CallbackInfo& info)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
@@ -398,6 +435,147 @@ Napi::Value NapiDataChannel::Send(const Napi::CallbackInfo& info)
     return info.Env().Undefined();
 }
 
+// sendMany(data: (string | ArrayBuffer | ArrayBufferView)[]): void;
+// sendMany(data: ArrayBuffer | ArrayBufferView, lengths: number[]): void;
+Napi::Value NapiDataChannel::SendMany(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (info.Length() == 0) {
+        NAPI_THROW(Error::New(info.Env(), "Wrong number of arguments"), info.Env().Undefined());
+    }
+
+    if (dataChannel_->state() != DataChannelInterface::kOpen) {
+        NAPI_THROW(Error::New(info.Env(), "Datachannel state is not open"), info.Env().Undefined());
+    }
+
+    std::vector<DataBuffer> buffers;
+
+    if (info[0].IsArray()) {
+        auto jsBuffers = info[0].As<Array>();
+        auto count = jsBuffers.Length();
+        buffers.reserve(count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            auto jsData = jsBuffers.Get(i);
+            if (jsData.IsString()) {
+                buffers.emplace_back(jsData.As<String>().Utf8Value());
+                continue;
+            }
+
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+            if (!JsToNativeBinaryData(jsData, data, size)) {
+                NAPI_THROW(TypeError::New(info.Env(), "Invalid type of element"), info.Env().Undefined());
+            }
+            buffers.emplace_back(rtc::CopyOnWriteBuffer(data, size), true);
+        }
+    } else {
+        // scatter a single buffer into consecutive messages, sharing one copy of the data
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        if (!JsToNativeBinaryData(info[0], data, size)) {
+            NAPI_THROW(
+                TypeError::New(info.Env(), "The first argument is not array or binary data"), info.Env().Undefined());
+        }
+
+        if (info.Length() < 2 || !info[1].IsArray()) {
+            NAPI_THROW(TypeError::New(info.Env(), "The second argument is not array"), info.Env().Undefined());
+        }
+
+        auto jsLengths = info[1].As<Array>();
+        auto count = jsLengths.Length();
+        buffers.reserve(count);
+
+        rtc::CopyOnWriteBuffer whole(data, size);
+        size_t offset = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            auto jsLength = jsLengths.Get(i);
+            if (!jsLength.IsNumber()) {
+                NAPI_THROW(TypeError::New(info.Env(), "Invalid type of length"), info.Env().Undefined());
+            }
+
+            auto length = jsLength.As<Number>().Int64Value();
+            if (length < 0 || static_cast<size_t>(length) > size - offset) {
+                NAPI_THROW(RangeError::New(info.Env(), "Lengths exceed the size of data"), info.Env().Undefined());
+            }
+
+            buffers.emplace_back(whole.Slice(offset, length), true);
+            offset += length;
+        }
+    }
+
+    SendBuffers(std::move(buffers));
+
+    return info.Env().Undefined();
+}
+
+// createWriter(options?: RTCDataChannelWriterOptions): RTCDataChannelWriter;
+Napi::Value NapiDataChannel::CreateWriter(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    DataChannelWriter::Options options;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        auto jsOptions = info[0].As<Object>();
+        if (jsOptions.Has("chunkSize")) {
+            auto jsChunkSize = jsOptions.Get("chunkSize");
+            if (jsChunkSize.IsNumber()) {
+                options.chunkSize = jsChunkSize.As<Number>().Uint32Value();
+            }
+        }
+        if (jsOptions.Has("highWaterMark")) {
+            auto jsHighWaterMark = jsOptions.Get("highWaterMark");
+            if (jsHighWaterMark.IsNumber()) {
+                options.highWaterMark = jsHighWaterMark.As<Number>().Int64Value();
+            }
+        }
+        if (jsOptions.Has("lowWaterMark")) {
+            auto jsLowWaterMark = jsOptions.Get("lowWaterMark");
+            if (jsLowWaterMark.IsNumber()) {
+                options.lowWaterMark = jsLowWaterMark.As<Number>().Int64Value();
+            }
+        }
+    }
+
+    if (options.chunkSize == 0 || options.lowWaterMark > options.highWaterMark ||
+        options.highWaterMark > DataChannelInterface::MaxSendQueueSize())
+    {
+        NAPI_THROW(RangeError::New(info.Env(), "Invalid options"), info.Env().Undefined());
+    }
+
+    // the writer clamps chunks to the negotiated max message size, which is unknown before the sctp transport
+    // is connected, but never exceeds what the local sctp stack accepts
+    auto maxMessageSize = static_cast<size_t>(cricket::kSctpSendBufferSize);
+    if (auto sctpTransport = pc_->GetSctpTransport()) {
+        auto information = sctpTransport->Information();
+        if (information.MaxMessageSize().has_value() && information.MaxMessageSize().value() >= 1) {
+            maxMessageSize = std::min(maxMessageSize, static_cast<size_t>(information.MaxMessageSize().value()));
+        }
+    }
+    if (options.chunkSize > maxMessageSize) {
+        NAPI_THROW(RangeError::New(info.Env(), "The chunkSize exceeds the max message size"), info.Env().Undefined());
+    }
+
+    auto writer = std::make_shared<DataChannelWriter>(factory_->GetNetworkThread(), pc_, dataChannel_, options);
+    {
+        UNUSED std::lock_guard<std::mutex> lock(writerMutex_);
+        if (writer_) {
+            // only one writer at a time
+            writer_->Close();
+        }
+        writer_ = writer;
+    }
+
+    return NapiDataChannelWriter::NewInstance(info.Env(), writer);
+}
+
+std::shared_ptr<DataChannelWriter> NapiDataChannel::GetWriter() const
+{
+    UNUSED std::lock_guard<std::mutex> lock(writerMutex_);
+    return writer_;
+}
+
 Napi::Value NapiDataChannel::ToJson(const Napi::CallbackInfo& info)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
@@ -418,6 +596,10 @@ void NapiDataChannel::OnStateChange()
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
+    if (auto writer = GetWriter()) {
+        writer->OnStateChange();
+    }
+
     auto state = dataChannel_->state();
     Dispatch(CallbackEvent<NapiDataChannel>::Create(
         [state](NapiDataChannel& channel) { channel.HandleStateChange(state); }));
@@ -427,8 +609,8 @@ void NapiDataChannel::OnMessage(const DataBuffer& buffer)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
-    Dispatch(
-        CallbackEvent<NapiDataChannel>::Create([buffer](NapiDataChannel& channel) { channel.HandleMessage(buffer); }));
+    Dispatch(CallbackEvent<NapiDataChannel>::Create(
+        [buffer](NapiDataChannel& channel) mutable { channel.HandleMessage(std::move(buffer)); }));
 }
 
 void NapiDataChannel::OnBufferedAmountChange(uint64_t sentDataSize)
@@ -437,6 +619,10 @@ void NapiDataChannel::OnBufferedAmountChange(uint64_t sentDataSize)
 
     (void)sentDataSize;
 
+    if (auto writer = GetWriter()) {
+        writer->OnBufferedAmountChange();
+    }
+
     auto bufferedAmount = dataChannel_->buffered_amount();
     auto bufferedAmountLowThreshold = bufferedAmountLowThreshold_.load();
     if (bufferedAmount > bufferedAmountLowThreshold) {
@@ -445,7 +631,8 @@ void NapiDataChannel::OnBufferedAmountChange(uint64_t sentDataSize)
         return;
     }
 
-    Dispatch(CallbackEvent<NapiDataChannel>::Create([](NapiDataChannel& channel) {
+    // Fires on every send completion below the threshold, only the latest pending one matters.
+    DispatchCoalesced(kEventNameBufferedAmountLow, CallbackEvent<NapiDataChannel>::Create([](NapiDataChannel& channel) {
         RTC_LOG(LS_VERBOSE) << "Dispatched: " << kEventNameBufferedAmountLow;
 
         auto env = channel.Env();
@@ -456,6 +643,26 @@ void NapiDataChannel::OnBufferedAmountChange(uint64_t sentDataSize)
     }));
 }
 
+void NapiDataChannel::SendBuffers(std::vector<DataBuffer> buffers)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " count=" << buffers.size();
+
+    if (buffers.empty()) {
+        return;
+    }
+
+    // Calls to the data channel proxy are executed directly on the network thread, so post once for the whole batch.
+    factory_->GetNetworkThread()->PostTask([dataChannel = dataChannel_, buffers = std::move(buffers)]() mutable {
+        for (auto& buffer : buffers) {
+            dataChannel->SendAsync(std::move(buffer), [](RTCError err) {
+                if (!err.ok()) {
+                    RTC_LOG(LS_ERROR) << "send buffer error: " << err.type() << ", " << err.message();
+                }
+            });
+        }
+    });
+}
+
 void NapiDataChannel::HandleStateChange(DataChannelInterface::DataState state)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
@@ -487,7 +694,7 @@ void NapiDataChannel::HandleStateChange(DataChannelInterface::DataState state)
     }
 }
 
-void NapiDataChannel::HandleMessage(const DataBuffer& buffer)
+void NapiDataChannel::HandleMessage(DataBuffer buffer)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
@@ -495,19 +702,31 @@ void NapiDataChannel::HandleMessage(const DataBuffer& buffer)
 
     Napi::Value value;
     if (buffer.binary) {
-        auto externalData = new rtc::CopyOnWriteBuffer(buffer.data);
-        auto arrayBuffer = ArrayBuffer::New(
-            Env(), static_cast<void*>(externalData->MutableData()), externalData->size(),
-            [](Napi::Env /*env*/, void* /*data*/, rtc::CopyOnWriteBuffer* hint) {
-                RTC_DLOG(LS_VERBOSE) << "release rtc::CopyOnWriteBuffer";
-                delete hint;
-            },
-            externalData);
-        value = arrayBuffer;
+        if (buffer.size() == 0) {
+            value = ArrayBuffer::New(Env(), 0);
+        } else {
+            // Take over the received buffer and expose its memory directly. The buffer is normally the only
+            // reference by now, otherwise MutableData() detaches it (deep copy) so JS never writes shared storage.
+            auto externalData = new rtc::CopyOnWriteBuffer(std::move(buffer.data));
+            const uint8_t* sharedData = externalData->cdata();
+            uint8_t* data = externalData->MutableData();
+            if (data != sharedData) {
+                receivedBytesCopied_ += externalData->size();
+            }
+            auto arrayBuffer = ArrayBuffer::New(
+                Env(), data, externalData->size(),
+                [](Napi::Env /*env*/, void* /*data*/, rtc::CopyOnWriteBuffer* hint) {
+                    RTC_DLOG(LS_VERBOSE) << "release rtc::CopyOnWriteBuffer";
+                    delete hint;
+                },
+                externalData);
+            value = arrayBuffer;
+        }
     } else {
         // Should be a UTF-8 string
-        auto str = String::New(Env(), reinterpret_cast<const char*>(buffer.data.data()), buffer.size());
+        auto str = String::New(Env(), reinterpret_cast<const char*>(buffer.data.cdata()), buffer.size());
         value = str;
+        receivedBytesCopied_ += buffer.size();
     }
 
     auto jsEvent = Object::New(Env());
@@ -517,6 +736,32 @@ void NapiDataChannel::HandleMessage(const DataBuffer& buffer)
     MakeCallback(kEventNameMessage, {jsEvent});
 }
 
+bool JsToNativeBinaryData(const Napi::Value& value, const uint8_t*& data, size_t& size)
+{
+    if (value.IsArrayBuffer()) {
+        auto jsArrayBuffer = value.As<ArrayBuffer>();
+        data = static_cast<const uint8_t*>(jsArrayBuffer.Data());
+        size = jsArrayBuffer.ByteLength();
+        return true;
+    }
+
+    if (value.IsTypedArray()) {
+        auto jsTypedArray = value.As<TypedArray>();
+        data = static_cast<const uint8_t*>(jsTypedArray.ArrayBuffer().Data()) + jsTypedArray.ByteOffset();
+        size = jsTypedArray.ByteLength();
+        return true;
+    }
+
+    if (value.IsDataView()) {
+        auto jsDataView = value.As<DataView>();
+        data = static_cast<const uint8_t*>(jsDataView.ArrayBuffer().Data()) + jsDataView.ByteOffset();
+        size = jsDataView.ByteLength();
+        return true;
+    }
+
+    return false;
+}
+
 void JsToNativeDataChannelInit(const Napi::Object& jsDataChannelInit, DataChannelInit& init)
 {
     if (jsDataChannelInit.Has(kAttributeNameOrdered)) {
@@ -17,18 +17,22 @@
 #define WEBRTC_DATA_CHANNEL_H
 
 #include <map>
+#include <vector>
 #include <atomic>
 #include <mutex>
 
 #include "napi.h"
 
 #include "api/data_channel_interface.h"
+#include "api/peer_connection_interface.h"
 
 #include "event/event_target.h"
 
 namespace webrtc {
 
 class NapiDataChannel;
+class PeerConnectionFactoryWrapper;
+class DataChannelWriter;
 
 class DataChannelObserverTemp : public EventQueue<NapiDataChannel>, public DataChannelObserver {
 public:
@@ -52,7 +56,9 @@ private:
 class NapiDataChannel : public NapiEventTarget<NapiDataChannel>, public DataChannelObserver {
 public:
     static void Init(Napi::Env env, Napi::Object exports);
-    static Napi::Object NewInstance(Napi::Env env, std::unique_ptr<DataChannelObserverTemp> observer);
+    static Napi::Object NewInstance(
+        std::shared_ptr<PeerConnectionFactoryWrapper> factory, rtc::scoped_refptr<PeerConnectionInterface> pc,
+        std::unique_ptr<DataChannelObserverTemp> observer);
 
     explicit NapiDataChannel(const Napi::CallbackInfo& info);
     ~NapiDataChannel() override;
@@ -74,12 +80,16 @@ protected:
     void SetBufferedAmountLowThreshold(const Napi::CallbackInfo& info, const Napi::Value& value);
     Napi::Value GetBinaryType(const Napi::CallbackInfo& info);
     void SetBinaryType(const Napi::CallbackInfo& info, const Napi::Value& value);
+    Napi::Value GetReceivedBytesCopied(const Napi::CallbackInfo& info);
+    Napi::Value GetCoalescedEventCount(const Napi::CallbackInfo& info);
 
     Napi::Value GetEventHandler(const Napi::CallbackInfo& info);
     void SetEventHandler(const Napi::CallbackInfo& info, const Napi::Value& value);
 
     Napi::Value Close(const Napi::CallbackInfo& info);
     Napi::Value Send(const Napi::CallbackInfo& info);
+    Napi::Value SendMany(const Napi::CallbackInfo& info);
+    Napi::Value CreateWriter(const Napi::CallbackInfo& info);
     Napi::Value ToJson(const Napi::CallbackInfo& info);
 
 protected:
@@ -90,20 +100,36 @@ protected:
     void OnBufferedAmountChange(uint64_t sentDataSize) override;
 
     void HandleStateChange(DataChannelInterface::DataState state);
-    void HandleMessage(const DataBuffer& buffer);
+    void HandleMessage(DataBuffer buffer);
+
+    // Send all buffers in a single task on the network thread
+    void SendBuffers(std::vector<DataBuffer> buffers);
+
+    std::shared_ptr<DataChannelWriter> GetWriter() const;
 
 private:
     static Napi::FunctionReference constructor_;
 
+    std::shared_ptr<PeerConnectionFactoryWrapper> factory_;
     std::unique_ptr<DataChannelObserverTemp> observerTemp_;
+    // for the max message size of the sctp transport
+    rtc::scoped_refptr<PeerConnectionInterface> pc_;
     rtc::scoped_refptr<DataChannelInterface> dataChannel_;
 
     std::string binaryType_;
     std::atomic<uint64_t> bufferedAmountLowThreshold_{0};
+    // bytes of received messages copied into js values, binary messages are delivered without copy
+    std::atomic<uint64_t> receivedBytesCopied_{0};
+
+    mutable std::mutex writerMutex_;
+    std::shared_ptr<DataChannelWriter> writer_;
 };
 
 void JsToNativeDataChannelInit(const Napi::Object& jsDataChannelInit, DataChannelInit& init);
 
+// Get the memory of an ArrayBuffer or ArrayBufferView, returns false for other types.
+bool JsToNativeBinaryData(const Napi::Value& value, const uint8_t*& data, size_t& size);
+
 } // namespace webrtc
 
 #endif // WEBRTC_DATA_CHANNEL_H
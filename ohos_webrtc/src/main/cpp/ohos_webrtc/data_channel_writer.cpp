@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "data_channel_writer.h"
+#include "data_channel.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+using namespace Napi;
+
+const char kClassName[] = "RTCDataChannelWriter";
+
+const char kAttributeNameChunkSize[] = "chunkSize";
+const char kAttributeNameHighWaterMark[] = "highWaterMark";
+const char kAttributeNameLowWaterMark[] = "lowWaterMark";
+const char kAttributeNamePendingBytes[] = "pendingBytes";
+const char kAttributeNamePaused[] = "paused";
+
+const char kMethodNameWrite[] = "write";
+const char kMethodNameFlush[] = "flush";
+const char kMethodNameClose[] = "close";
+const char kMethodNameToJson[] = "toJSON";
+
+DataChannelWriter::DataChannelWriter(
+    rtc::Thread* networkThread, rtc::scoped_refptr<PeerConnectionInterface> pc,
+    rtc::scoped_refptr<DataChannelInterface> dataChannel, const Options& options)
+    : networkThread_(networkThread), pc_(std::move(pc)), dataChannel_(std::move(dataChannel)), options_(options)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+}
+
+DataChannelWriter::~DataChannelWriter()
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+}
+
+void DataChannelWriter::SetObserver(Observer* observer)
+{
+    observer_ = observer;
+}
+
+void DataChannelWriter::Write(uint64_t id, rtc::CopyOnWriteBuffer data)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " id=" << id << ", size=" << data.size();
+
+    pendingBytes_ += data.size();
+    networkThread_->PostTask([self = shared_from_this(), id, data = std::move(data)]() mutable {
+        if (self->closed_) {
+            self->pendingBytes_ -= data.size();
+            return;
+        }
+
+        self->writes_.push_back({id, std::move(data), 0, false, 0});
+        self->Pump();
+    });
+}
+
+void DataChannelWriter::Flush(uint64_t id)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " id=" << id;
+
+    networkThread_->PostTask([self = shared_from_this(), id] {
+        if (self->closed_) {
+            return;
+        }
+
+        self->writes_.push_back({id, rtc::CopyOnWriteBuffer(), 0, true, 0});
+        self->Pump();
+    });
+}
+
+void DataChannelWriter::Close()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    networkThread_->PostTask([self = shared_from_this()] {
+        self->CloseInternal(RTCError(RTCErrorType::INVALID_STATE, "Writer is closed"));
+    });
+}
+
+void DataChannelWriter::OnBufferedAmountChange()
+{
+    networkThread_->PostTask([self = shared_from_this()] {
+        if (self->paused_ &&
+            self->dataChannel_->buffered_amount() + self->bytesInFlight_ > self->options_.lowWaterMark)
+        {
+            return;
+        }
+
+        self->paused_ = false;
+        self->Pump();
+    });
+}
+
+void DataChannelWriter::OnStateChange()
+{
+    networkThread_->PostTask([self = shared_from_this()] {
+        auto state = self->dataChannel_->state();
+        if (state == DataChannelInterface::kClosing || state == DataChannelInterface::kClosed) {
+            self->CloseInternal(RTCError(RTCErrorType::INVALID_STATE, "Datachannel is closed"));
+            return;
+        }
+
+        self->Pump();
+    });
+}
+
+void DataChannelWriter::Pump()
+{
+    RTC_DCHECK_RUN_ON(networkThread_);
+
+    while (!closed_ && !writes_.empty()) {
+        auto state = dataChannel_->state();
+        if (state == DataChannelInterface::kConnecting) {
+            // wait for open
+            return;
+        }
+
+        if (state != DataChannelInterface::kOpen) {
+            CloseInternal(RTCError(RTCErrorType::INVALID_STATE, "Datachannel is closed"));
+            return;
+        }
+
+        auto& write = writes_.front();
+        if (write.offset < write.data.size()) {
+            if (dataChannel_->buffered_amount() + bytesInFlight_ >= options_.highWaterMark) {
+                // resumed by OnBufferedAmountChange once below the low water mark, or by OnChunkSent
+                paused_ = true;
+                return;
+            }
+
+            auto size = std::min(GetChunkSize(), write.data.size() - write.offset);
+            dataChannel_->SendAsync(DataBuffer(write.data.Slice(write.offset, size), true),
+                [self = shared_from_this(), id = write.id, size](RTCError err) {
+                    // may complete synchronously, never reenter Pump
+                    self->networkThread_->PostTask([self, id, size, err = std::move(err)]() mutable {
+                        self->OnChunkSent(id, size, std::move(err));
+                    });
+                });
+            write.offset += size;
+            write.chunksInFlight++;
+            bytesInFlight_ += size;
+            pendingBytes_ -= size;
+            continue;
+        }
+
+        if (write.chunksInFlight > 0) {
+            // completed by OnChunkSent
+            return;
+        }
+
+        if (write.flush && dataChannel_->buffered_amount() > 0) {
+            // completed by OnBufferedAmountChange
+            return;
+        }
+
+        auto id = write.id;
+        writes_.pop_front();
+        if (observer_) {
+            observer_->OnWriteComplete(id, RTCError::OK());
+        }
+    }
+}
+
+void DataChannelWriter::OnChunkSent(uint64_t id, size_t size, RTCError error)
+{
+    RTC_DCHECK_RUN_ON(networkThread_);
+
+    bytesInFlight_ -= std::min<uint64_t>(size, bytesInFlight_);
+    if (closed_) {
+        return;
+    }
+
+    auto it = std::find_if(writes_.begin(), writes_.end(), [id](const PendingWrite& write) { return write.id == id; });
+    if (it != writes_.end() && it->chunksInFlight > 0) {
+        it->chunksInFlight--;
+    }
+
+    if (!error.ok()) {
+        RTC_LOG(LS_ERROR) << "send chunk error: " << error.type() << ", " << error.message();
+        // the remaining chunks of the stream would be out of place, fail the write and everything after it
+        CloseInternal(std::move(error));
+        return;
+    }
+
+    if (paused_ && dataChannel_->buffered_amount() + bytesInFlight_ > options_.lowWaterMark) {
+        return;
+    }
+
+    paused_ = false;
+    Pump();
+}
+
+size_t DataChannelWriter::GetChunkSize() const
+{
+    RTC_DCHECK_RUN_ON(networkThread_);
+
+    auto sctpTransport = pc_ ? pc_->GetSctpTransport() : nullptr;
+    if (!sctpTransport) {
+        return options_.chunkSize;
+    }
+
+    auto maxMessageSize = sctpTransport->Information().MaxMessageSize();
+    if (!maxMessageSize.has_value() || maxMessageSize.value() < 1) {
+        return options_.chunkSize;
+    }
+
+    return std::min(options_.chunkSize, static_cast<size_t>(maxMessageSize.value()));
+}
+
+void DataChannelWriter::CloseInternal(RTCError error)
+{
+    RTC_DCHECK_RUN_ON(networkThread_);
+
+    if (closed_) {
+        return;
+    }
+
+    RTC_LOG(LS_INFO) << "Close writer: " << error.message();
+
+    closed_ = true;
+    paused_ = false;
+    pendingBytes_ = 0;
+
+    auto writes = std::move(writes_);
+    writes_.clear();
+
+    if (observer_) {
+        for (auto& write : writes) {
+            observer_->OnWriteComplete(write.id, error);
+        }
+        observer_->OnWriterClosed();
+        observer_ = nullptr;
+    }
+}
+
+FunctionReference NapiDataChannelWriter::constructor_;
+
+void NapiDataChannelWriter::Init(Napi::Env env, Napi::Object exports)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    Function func = DefineClass(
+        env, kClassName,
+        {
+            InstanceAccessor<&NapiDataChannelWriter::GetChunkSize>(kAttributeNameChunkSize),
+            InstanceAccessor<&NapiDataChannelWriter::GetHighWaterMark>(kAttributeNameHighWaterMark),
+            InstanceAccessor<&NapiDataChannelWriter::GetLowWaterMark>(kAttributeNameLowWaterMark),
+            InstanceAccessor<&NapiDataChannelWriter::GetPendingBytes>(kAttributeNamePendingBytes),
+            InstanceAccessor<&NapiDataChannelWriter::GetPaused>(kAttributeNamePaused),
+            InstanceMethod<&NapiDataChannelWriter::Write>(kMethodNameWrite),
+            InstanceMethod<&NapiDataChannelWriter::Flush>(kMethodNameFlush),
+            InstanceMethod<&NapiDataChannelWriter::Close>(kMethodNameClose),
+            InstanceMethod<&NapiDataChannelWriter::ToJson>(kMethodNameToJson),
+        });
+    exports.Set(kClassName, func);
+
+    constructor_ = Persistent(func);
+}
+
+Napi::Object NapiDataChannelWriter::NewInstance(Napi::Env env, std::shared_ptr<DataChannelWriter> writer)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (!writer) {
+        NAPI_THROW(Error::New(env, "Invalid argument"), Object::New(env));
+    }
+
+    return constructor_.New({External<std::shared_ptr<DataChannelWriter>>::New(env, &writer)});
+}
+
+NapiDataChannelWriter::NapiDataChannelWriter(const Napi::CallbackInfo& info)
+    : NapiEventTarget<NapiDataChannelWriter>(info)
+{
+    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+
+    // Create from native, and SHOULD NOT create from ArkTS
+    if (info.Length() != 1 || !info[0].IsExternal()) {
+        NAPI_THROW_VOID(Error::New(info.Env(), "Invalid Operation"));
+    }
+
+    writer_ = *info[0].As<External<std::shared_ptr<DataChannelWriter>>>().Data();
+    writer_->SetObserver(this);
+}
+
+NapiDataChannelWriter::~NapiDataChannelWriter()
+{
+    RTC_DLOG(LS_INFO) << __FUNCTION__;
+}
+
+Napi::Value NapiDataChannelWriter::GetChunkSize(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), writer_->GetOptions().chunkSize);
+}
+
+Napi::Value NapiDataChannelWriter::GetHighWaterMark(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), writer_->GetOptions().highWaterMark);
+}
+
+Napi::Value NapiDataChannelWriter::GetLowWaterMark(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), writer_->GetOptions().lowWaterMark);
+}
+
+Napi::Value NapiDataChannelWriter::GetPendingBytes(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), writer_->GetPendingBytes());
+}
+
+Napi::Value NapiDataChannelWriter::GetPaused(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Boolean::New(info.Env(), writer_->IsPaused());
+}
+
+// write(data: ArrayBuffer | ArrayBufferView): Promise<void>;
+Napi::Value NapiDataChannelWriter::Write(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto deferred = Promise::Deferred::New(info.Env());
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (info.Length() == 0 || !JsToNativeBinaryData(info[0], data, size)) {
+        deferred.Reject(TypeError::New(info.Env(), "The argument is not binary data").Value());
+        return deferred.Promise();
+    }
+
+    if (ShouldStop()) {
+        deferred.Reject(Error::New(info.Env(), "Writer is closed").Value());
+        return deferred.Promise();
+    }
+
+    auto id = nextWriteId_++;
+    pendingWrites_.emplace(id, deferred);
+    writer_->Write(id, rtc::CopyOnWriteBuffer(data, size));
+
+    return deferred.Promise();
+}
+
+// flush(): Promise<void>;
+Napi::Value NapiDataChannelWriter::Flush(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto deferred = Promise::Deferred::New(info.Env());
+
+    if (ShouldStop()) {
+        deferred.Reject(Error::New(info.Env(), "Writer is closed").Value());
+        return deferred.Promise();
+    }
+
+    auto id = nextWriteId_++;
+    pendingWrites_.emplace(id, deferred);
+    writer_->Flush(id);
+
+    return deferred.Promise();
+}
+
+Napi::Value NapiDataChannelWriter::Close(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    writer_->Close();
+    return info.Env().Undefined();
+}
+
+Napi::Value NapiDataChannelWriter::ToJson(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto json = Object::New(info.Env());
+#ifndef NDEBUG
+    json.Set("__native_class__", "NapiDataChannelWriter");
+#endif
+    json.Set(kAttributeNameChunkSize, GetChunkSize(info));
+    json.Set(kAttributeNameHighWaterMark, GetHighWaterMark(info));
+    json.Set(kAttributeNameLowWaterMark, GetLowWaterMark(info));
+    json.Set(kAttributeNamePendingBytes, GetPendingBytes(info));
+
+    return json;
+}
+
+void NapiDataChannelWriter::OnWriteComplete(uint64_t id, RTCError error)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " id=" << id;
+
+    Dispatch(CallbackEvent<NapiDataChannelWriter>::Create(
+        [id, error](NapiDataChannelWriter& target) { target.HandleWriteComplete(id, error); }));
+}
+
+void NapiDataChannelWriter::OnWriterClosed()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    // Stop on the js thread, after the completions dispatched before
+    Dispatch(CallbackEvent<NapiDataChannelWriter>::Create([](NapiDataChannelWriter& target) { target.Stop(); }));
+}
+
+void NapiDataChannelWriter::HandleWriteComplete(uint64_t id, const RTCError& error)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " id=" << id;
+
+    auto it = pendingWrites_.find(id);
+    if (it == pendingWrites_.end()) {
+        RTC_LOG(LS_WARNING) << "No pending write: " << id;
+        return;
+    }
+
+    auto deferred = it->second;
+    pendingWrites_.erase(it);
+
+    HandleScope scope(Env());
+    if (error.ok()) {
+        deferred.Resolve(Env().Undefined());
+    } else {
+        auto message = error.message();
+        deferred.Reject(Error::New(Env(), (message && strlen(message) > 0) ? message : "unknown error").Value());
+    }
+}
+
+void NapiDataChannelWriter::DidStop()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    // writes arrived after the writer was closed on network thread
+    HandleScope scope(Env());
+    for (auto& pendingWrite : pendingWrites_) {
+        pendingWrite.second.Reject(Error::New(Env(), "Writer is closed").Value());
+    }
+    pendingWrites_.clear();
+}
+
+} // namespace webrtc
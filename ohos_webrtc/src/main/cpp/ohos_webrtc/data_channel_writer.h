@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_DATA_CHANNEL_WRITER_H
+#define WEBRTC_DATA_CHANNEL_WRITER_H
+
+#include <map>
+#include <deque>
+#include <atomic>
+#include <memory>
+
+#include "napi.h"
+
+#include "api/data_channel_interface.h"
+#include "api/peer_connection_interface.h"
+#include "rtc_base/thread.h"
+
+#include "event/event_target.h"
+
+namespace webrtc {
+
+// Splits large writes into chunks and sends them with flow control on the buffered amount of the data channel.
+// All the sending happens on the network thread, the public methods can be called from any thread.
+class DataChannelWriter : public std::enable_shared_from_this<DataChannelWriter> {
+public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+    static constexpr uint64_t kDefaultHighWaterMark = 1024 * 1024;
+    static constexpr uint64_t kDefaultLowWaterMark = 256 * 1024;
+
+    struct Options {
+        size_t chunkSize = kDefaultChunkSize;
+        uint64_t highWaterMark = kDefaultHighWaterMark;
+        uint64_t lowWaterMark = kDefaultLowWaterMark;
+    };
+
+    class Observer {
+    public:
+        virtual ~Observer() = default;
+
+        // Called on the network thread.
+        virtual void OnWriteComplete(uint64_t id, RTCError error) = 0;
+        // Called on the network thread, no more callbacks after this one.
+        virtual void OnWriterClosed() = 0;
+    };
+
+    DataChannelWriter(
+        rtc::Thread* networkThread, rtc::scoped_refptr<PeerConnectionInterface> pc,
+        rtc::scoped_refptr<DataChannelInterface> dataChannel, const Options& options);
+    ~DataChannelWriter();
+
+    // Must be called before the first write.
+    void SetObserver(Observer* observer);
+
+    // Queue data to be sent, the write completes once all its chunks are accepted by the data channel. The first
+    // chunk failing to send fails the write and closes the writer.
+    void Write(uint64_t id, rtc::CopyOnWriteBuffer data);
+    // Completes once everything written before has been sent and the buffered amount has dropped to zero.
+    void Flush(uint64_t id);
+    // Fail all pending writes and detach the observer.
+    void Close();
+
+    void OnBufferedAmountChange();
+    void OnStateChange();
+
+    const Options& GetOptions() const
+    {
+        return options_;
+    }
+
+    uint64_t GetPendingBytes() const
+    {
+        return pendingBytes_.load();
+    }
+
+    bool IsPaused() const
+    {
+        return paused_.load();
+    }
+
+private:
+    struct PendingWrite {
+        uint64_t id;
+        rtc::CopyOnWriteBuffer data;
+        size_t offset;
+        bool flush;
+        // chunks handed to the data channel and not yet reported
+        size_t chunksInFlight;
+    };
+
+    void Pump();
+    void OnChunkSent(uint64_t id, size_t size, RTCError error);
+    void CloseInternal(RTCError error);
+
+    // the chunk size limited to the max message size of the sctp transport once known
+    size_t GetChunkSize() const;
+
+private:
+    rtc::Thread* const networkThread_;
+    const rtc::scoped_refptr<PeerConnectionInterface> pc_;
+    const rtc::scoped_refptr<DataChannelInterface> dataChannel_;
+    const Options options_;
+
+    // accessed on network thread only
+    Observer* observer_{};
+    std::deque<PendingWrite> writes_;
+    // bytes handed to the data channel but not yet counted in its buffered amount
+    uint64_t bytesInFlight_{0};
+    bool closed_{false};
+
+    std::atomic<uint64_t> pendingBytes_{0};
+    std::atomic<bool> paused_{false};
+};
+
+class NapiDataChannelWriter : public NapiEventTarget<NapiDataChannelWriter>, public DataChannelWriter::Observer {
+public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    static Napi::Object NewInstance(Napi::Env env, std::shared_ptr<DataChannelWriter> writer);
+
+    ~NapiDataChannelWriter() override;
+
+protected:
+    friend class ObjectWrap;
+
+    explicit NapiDataChannelWriter(const Napi::CallbackInfo& info);
+
+protected:
+    // JS
+    Napi::Value GetChunkSize(const Napi::CallbackInfo& info);
+    Napi::Value GetHighWaterMark(const Napi::CallbackInfo& info);
+    Napi::Value GetLowWaterMark(const Napi::CallbackInfo& info);
+    Napi::Value GetPendingBytes(const Napi::CallbackInfo& info);
+    Napi::Value GetPaused(const Napi::CallbackInfo& info);
+
+    Napi::Value Write(const Napi::CallbackInfo& info);
+    Napi::Value Flush(const Napi::CallbackInfo& info);
+    Napi::Value Close(const Napi::CallbackInfo& info);
+    Napi::Value ToJson(const Napi::CallbackInfo& info);
+
+    void OnWriteComplete(uint64_t id, RTCError error) override;
+    void OnWriterClosed() override;
+
+    void HandleWriteComplete(uint64_t id, const RTCError& error);
+
+    void DidStop() override;
+
+private:
+    static Napi::FunctionReference constructor_;
+
+    std::shared_ptr<DataChannelWriter> writer_;
+
+    // accessed on js thread only
+    uint64_t nextWriteId_{0};
+    std::map<uint64_t, Napi::Promise::Deferred> pendingWrites_;
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_DATA_CHANNEL_WRITER_H
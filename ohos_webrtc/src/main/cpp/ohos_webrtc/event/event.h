@@ -16,17 +16,27 @@
 #ifndef WEBRTC_EVENT_EVENT_H
 #define WEBRTC_EVENT_EVENT_H
 
+#include <atomic>
 #include <memory>
 #include <functional>
 
 namespace webrtc {
 
+template <typename T>
+class EventQueue;
+
 template <typename T>
 class Event {
 public:
     virtual ~Event() = default;
 
     virtual void Process(T&) = 0;
+
+private:
+    friend class EventQueue<T>;
+
+    // intrusive link, owned by EventQueue
+    std::atomic<Event<T>*> next_{nullptr};
 };
 
 template <typename T>
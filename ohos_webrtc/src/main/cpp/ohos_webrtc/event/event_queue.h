@@ -16,8 +16,7 @@
 #ifndef WEBRTC_EVENT_EVENT_QUEUE_H
 #define WEBRTC_EVENT_EVENT_QUEUE_H
 
-#include <mutex>
-#include <queue>
+#include <atomic>
 #include <memory>
 
 #include "event.h"
@@ -25,31 +24,83 @@
 
 namespace webrtc {
 
+// Intrusive lock-free multi-producer/single-consumer queue (Vyukov).
+// Enqueue may be called from any thread, Dequeue only from the consumer thread.
 template <typename T>
 class EventQueue {
 public:
+    EventQueue() : head_(&stub_), tail_(&stub_) {}
+
+    virtual ~EventQueue()
+    {
+        while (Dequeue()) {
+        }
+    }
+
     void Enqueue(std::unique_ptr<Event<T>> event)
     {
-        UNUSED std::lock_guard<std::mutex> lock(mutex_);
-        events_.push(std::move(event));
+        Push(event.release());
     }
 
+    // Returns nullptr when empty, or when a producer is in the middle of an enqueue. In the latter case that
+    // producer is guaranteed to observe the queue as no longer drained, see NapiEventTarget::Dispatch.
     std::unique_ptr<Event<T>> Dequeue()
     {
-        UNUSED std::lock_guard<std::mutex> lock(mutex_);
-        if (events_.empty()) {
+        Event<T>* tail = tail_;
+        Event<T>* next = tail->next_.load(std::memory_order_acquire);
+
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail_ = next;
+            return std::unique_ptr<Event<T>>(tail);
+        }
+
+        if (tail != head_.load(std::memory_order_acquire)) {
             return nullptr;
         }
 
-        auto event = std::move(events_.front());
-        events_.pop();
+        Push(&stub_);
 
-        return event;
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return std::unique_ptr<Event<T>>(tail);
+        }
+
+        return nullptr;
+    }
+
+    // Whether the event is the last one enqueued, the event must not have been processed yet.
+    bool IsLast(const Event<T>* event) const
+    {
+        return head_.load(std::memory_order_acquire) == event;
+    }
+
+private:
+    class StubEvent : public Event<T> {
+    public:
+        void Process(T&) override {}
+    };
+
+    void Push(Event<T>* event)
+    {
+        event->next_.store(nullptr, std::memory_order_relaxed);
+        Event<T>* prev = head_.exchange(event, std::memory_order_acq_rel);
+        prev->next_.store(event, std::memory_order_release);
     }
 
 private:
-    std::queue<std::unique_ptr<Event<T>>> events_;
-    std::mutex mutex_;
+    StubEvent stub_;
+    std::atomic<Event<T>*> head_;
+    Event<T>* tail_;
 };
 
 } // namespace webrtc
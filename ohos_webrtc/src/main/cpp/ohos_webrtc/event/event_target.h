@@ -17,7 +17,8 @@
 #define WEBRTC_EVENT_EVENT_TARGET_H
 
 #include <map>
-#include <queue>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -58,10 +59,44 @@ public:
 
         this->Enqueue(std::move(event));
 
-        napi_status status = tsfn_.BlockingCall([](Napi::Env env, Napi::Function func) { func.Call({}); });
+        // Only wake up the js thread once per burst, Run() drains everything queued until then.
+        if (scheduled_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        napi_status status = tsfn_.NonBlockingCall([](Napi::Env env, Napi::Function func) { func.Call({}); });
         if (status != napi_ok) {
             RTC_LOG(LS_ERROR) << " tsfn call error: " << status;
+            scheduled_.store(false, std::memory_order_release);
+        }
+    }
+
+    // Dispatch an event which supersedes the pending event of the same type, if no other event was dispatched since
+    // then. Events are never reordered, an event separated from the pending one by any other event is queued as well.
+    void DispatchCoalesced(const std::string& type, std::unique_ptr<Event<T>> event)
+    {
+        RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << ": " << type;
+
+        UNUSED std::lock_guard<std::mutex> lock(coalescingMutex_);
+        auto& slot = coalescedEvents_[type];
+        // the placeholder is alive as long as the event of its slot was not taken
+        if (slot && slot->event && this->IsLast(slot->placeholder)) {
+            slot->event = std::move(event);
+            coalescedEventCount_.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+
+        slot = std::make_shared<CoalescedSlot>();
+        slot->event = std::move(event);
+        auto placeholder = CallbackEvent<T>::Create(
+            [this, type, slot](T& target) { this->ProcessCoalesced(type, slot, target); });
+        slot->placeholder = placeholder.get();
+        Dispatch(std::move(placeholder));
+    }
+
+    uint64_t GetCoalescedEventCount() const
+    {
+        return coalescedEventCount_.load(std::memory_order_relaxed);
     }
 
     virtual void Stop()
@@ -118,6 +153,10 @@ protected:
         RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
         Napi::HandleScope scope(info.Env());
+
+        // Clear before draining, so that any event enqueued from now on schedules a new call.
+        scheduled_.exchange(false, std::memory_order_acq_rel);
+
         while (!shouldStop_) {
             auto event = this->Dequeue();
             if (!event) {
@@ -155,11 +194,40 @@ protected:
         func.MakeCallback(self, args);
     }
 
+private:
+    // the latest event of a type, processed in place of the placeholder event queued for it
+    struct CoalescedSlot {
+        std::unique_ptr<Event<T>> event;
+        const Event<T>* placeholder{nullptr};
+    };
+
+    void ProcessCoalesced(const std::string& type, const std::shared_ptr<CoalescedSlot>& slot, T& target)
+    {
+        std::unique_ptr<Event<T>> event;
+        {
+            UNUSED std::lock_guard<std::mutex> lock(coalescingMutex_);
+            event = std::move(slot->event);
+            auto it = coalescedEvents_.find(type);
+            if (it != coalescedEvents_.end() && it->second == slot) {
+                coalescedEvents_.erase(it);
+            }
+        }
+
+        if (event) {
+            event->Process(target);
+        }
+    }
+
 private:
     std::atomic<bool> shouldStop_{false};
+    std::atomic<bool> scheduled_{false};
     mutable std::mutex mutex_;
     std::map<std::string, Napi::FunctionReference> eventHandlers_;
     Napi::ThreadSafeFunction tsfn_;
+
+    std::mutex coalescingMutex_;
+    std::map<std::string, std::shared_ptr<CoalescedSlot>> coalescedEvents_;
+    std::atomic<uint64_t> coalescedEventCount_{0};
 };
 
 } // namespace webrtc
@@ -53,6 +53,7 @@ const char kAttributeNameRole[] = "role";
 const char kAttributeNameComponent[] = "component";
 const char kAttributeNameState[] = "state";
 const char kAttributeNameGatheringState[] = "gatheringState";
+const char kAttributeNameCoalescedEventCount[] = "coalescedEventCount";
 const char kAttributeNameOnStateChange[] = "onstatechange";
 const char kAttributeNameOnGatheringStateChange[] = "ongatheringstatechange";
 const char kAttributeNameOnSelectedCandidatePairChange[] = "onselectedcandidatepairchange";
@@ -78,6 +79,7 @@ void NapiIceTransport::Init(Napi::Env env, Napi::Object exports)
             InstanceAccessor<&NapiIceTransport::GetComponent>(kAttributeNameComponent),
             InstanceAccessor<&NapiIceTransport::GetState>(kAttributeNameState),
             InstanceAccessor<&NapiIceTransport::GetGatheringState>(kAttributeNameGatheringState),
+            InstanceAccessor<&NapiIceTransport::GetCoalescedEventCount>(kAttributeNameCoalescedEventCount),
             InstanceAccessor<&NapiIceTransport::GetEventHandler, &NapiIceTransport::SetEventHandler>(
                 kAttributeNameOnStateChange, napi_default, (void*)kEventNameStateChange),
             InstanceAccessor<&NapiIceTransport::GetEventHandler, &NapiIceTransport::SetEventHandler>(
@@ -236,6 +238,13 @@ Napi::Value NapiIceTransport::GetGatheringState(const Napi::CallbackInfo& info)
     NAPI_THROW(Error::New(info.Env(), "Invalid gathering state"), info.Env().Undefined());
 }
 
+// readonly coalescedEventCount : number;
+Napi::Value NapiIceTransport::GetCoalescedEventCount(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), NapiEventTarget::GetCoalescedEventCount());
+}
+
 Napi::Value NapiIceTransport::GetEventHandler(const Napi::CallbackInfo& info)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
@@ -325,7 +334,8 @@ void NapiIceTransport::OnGatheringStateChange(cricket::IceTransportInternal* ice
 
     iceGatheringState_ = iceTransport->gathering_state();
 
-    Dispatch(
+    DispatchCoalesced(
+        kEventNameGatheringStateChange,
         CallbackEvent<NapiIceTransport>::Create([this, state = iceGatheringState_.load()](NapiIceTransport& target) {
             RTC_DCHECK_EQ(this, &target);
 
@@ -51,6 +51,7 @@ protected:
     Napi::Value GetComponent(const Napi::CallbackInfo& info);
     Napi::Value GetState(const Napi::CallbackInfo& info);
     Napi::Value GetGatheringState(const Napi::CallbackInfo& info);
+    Napi::Value GetCoalescedEventCount(const Napi::CallbackInfo& info);
 
     Napi::Value GetEventHandler(const Napi::CallbackInfo& info);
     void SetEventHandler(const Napi::CallbackInfo& info, const Napi::Value& value);
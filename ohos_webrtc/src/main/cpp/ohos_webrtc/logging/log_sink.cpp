@@ -21,16 +21,80 @@ using namespace std;
 using namespace Napi;
 
 const char kMethodNameLogMessage[] = "logMessage";
+const char kMethodNameLogMessages[] = "logMessages";
+
+const char kAttributeNameMessage[] = "message";
+const char kAttributeNameSeverity[] = "severity";
+const char kAttributeNameTag[] = "tag";
+
+// records delivered by one call into js at most, the rest are left to the next call
+constexpr size_t kMaxBatchSize = 256;
+
+LogRecordRing::LogRecordRing(size_t capacity)
+    : mask_(capacity - 1), slots_(std::make_unique<Slot[]>(capacity))
+{
+    RTC_DCHECK(capacity > 0 && (capacity & (capacity - 1)) == 0) << "capacity must be a power of 2";
+
+    for (size_t i = 0; i < capacity; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogRecordRing::TryPush(rtc::LoggingSeverity severity, absl::string_view message, absl::string_view tag)
+{
+    Slot* slot;
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        slot = &slots_[pos & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the consumer has not released the slot yet
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record.severity = severity;
+    slot->record.message.assign(message.data(), message.size());
+    slot->record.tag.assign(tag.data(), tag.size());
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+struct LogSink::Context {
+    explicit Context(Napi::Object loggable) : loggable(Napi::Persistent(loggable)), ring(kDefaultCapacity) {}
+
+    Napi::ObjectReference loggable;
+    LogRecordRing ring;
+    TSFN tsfn;
+    // whether a call into js is pending
+    std::atomic<bool> scheduled{false};
+    std::atomic<uint64_t> dropped{0};
+};
 
 LogSink::LogSink(napi_env env, Napi::Object loggable)
 {
-    if (!loggable.Has(kMethodNameLogMessage)) {
+    auto jsLogMessage = loggable.Get(kMethodNameLogMessage);
+    auto jsLogMessages = loggable.Get(kMethodNameLogMessages);
+    if (!jsLogMessage.IsFunction() && !jsLogMessages.IsFunction()) {
         NAPI_THROW_VOID(Error::New(env, "Invalid argument"));
     }
 
+    // the callback is used for the records one by one only, in case there is no logMessages
+    auto callback = jsLogMessage.IsFunction() ? jsLogMessage.As<Function>() : jsLogMessages.As<Function>();
+
+    context_ = new Context(loggable);
     tsfn_ = TSFN::New(
-        env, loggable.Get(kMethodNameLogMessage).As<Function>(), kMethodNameLogMessage, 0, 1,
-        new Context(Napi::Persistent(loggable)), [](Napi::Env, FinalizerDataType*, Context* ctx) { delete ctx; });
+        env, callback, kMethodNameLogMessage, 0, 1, context_,
+        [](Napi::Env, FinalizerDataType*, Context* ctx) { delete ctx; });
+    context_->tsfn = tsfn_;
 }
 
 LogSink::~LogSink()
@@ -45,32 +109,94 @@ void LogSink::OnLogMessage(const string& msg)
 
 void LogSink::OnLogMessage(const string& msg, rtc::LoggingSeverity severity, const char* tag)
 {
-    tsfn_.BlockingCall(new DataType{severity, msg, tag});
+    Enqueue(severity, msg, tag);
 }
 
 void LogSink::OnLogMessage(absl::string_view msg, rtc::LoggingSeverity severity, const char* tag)
 {
-    tsfn_.BlockingCall(new DataType{severity, std::string(msg), tag});
+    Enqueue(severity, msg, tag);
 }
 
 void LogSink::OnLogMessage(const rtc::LogLineRef& line)
 {
-    // Inefficient
-    tsfn_.BlockingCall(new DataType{line.severity(), line.DefaultLogLine(), std::string(line.tag())});
+    Enqueue(line.severity(), line.DefaultLogLine(), line.tag());
 }
 
-void LogSink::CallJs(Napi::Env env, Napi::Function callback, Context* context, DataType* data)
+uint64_t LogSink::GetDroppedCount() const
+{
+    return context_ ? context_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void LogSink::Enqueue(rtc::LoggingSeverity severity, absl::string_view msg, absl::string_view tag)
+{
+    if (!context_) {
+        return;
+    }
+
+    if (!context_->ring.TryPush(severity, msg, tag)) {
+        context_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Schedule(context_);
+}
+
+void LogSink::Schedule(Context* context)
+{
+    // one pending call drains everything queued before it runs
+    if (context->scheduled.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    if (context->tsfn.NonBlockingCall() != napi_ok) {
+        context->scheduled.store(false, std::memory_order_release);
+    }
+}
+
+void LogSink::CallJs(Napi::Env env, Napi::Function callback, Context* context, DataType*)
 {
     if (env == nullptr) {
         // Javascript environment is not available to call into
         return;
     }
 
-    callback.Call(
-        context->Value(),
-        {String::New(env, data->msg.data()), Number::New(env, data->severity), String::New(env, data->tag)});
+    // records queued from now on need another call
+    context->scheduled.exchange(false, std::memory_order_acq_rel);
+
+    auto loggable = context->loggable.Value();
+    auto jsLogMessages = loggable.Get(kMethodNameLogMessages);
+    bool batched = jsLogMessages.IsFunction();
+
+    auto jsRecords = Array::New(env);
+    uint32_t count = 0;
+    auto deliver = [&](const LogRecordRing::Record& record) {
+        auto jsMessage = String::New(env, record.message);
+        auto jsSeverity = Number::New(env, record.severity);
+        auto jsTag = String::New(env, record.tag);
+        if (!batched) {
+            callback.Call(loggable, {jsMessage, jsSeverity, jsTag});
+            return;
+        }
+
+        auto jsRecord = Object::New(env);
+        jsRecord.Set(kAttributeNameMessage, jsMessage);
+        jsRecord.Set(kAttributeNameSeverity, jsSeverity);
+        jsRecord.Set(kAttributeNameTag, jsTag);
+        jsRecords[count] = jsRecord;
+    };
+
+    while (count < kMaxBatchSize && context->ring.TryPop(deliver)) {
+        count++;
+    }
+
+    if (batched && count > 0) {
+        jsLogMessages.As<Function>().Call(loggable, {jsRecords});
+    }
 
-    delete data;
+    if (count == kMaxBatchSize) {
+        // there may be more, let other tasks of the js thread run in between
+        Schedule(context);
+    }
 }
 
 } // namespace webrtc
@@ -16,6 +16,8 @@
 #ifndef WEBRTC_LOG_SINK_H
 #define WEBRTC_LOG_SINK_H
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 #include "napi.h"
@@ -24,8 +26,56 @@
 
 namespace webrtc {
 
+// Bounded lock-free queue of log records, for many producers and a single consumer.
+// The strings of a slot keep their capacity, so that no allocation is needed once the ring is warmed up.
+class LogRecordRing {
+public:
+    struct Record {
+        rtc::LoggingSeverity severity;
+        std::string message;
+        std::string tag;
+    };
+
+    explicit LogRecordRing(size_t capacity);
+
+    // Return false if the ring is full. Can be called from any thread.
+    bool TryPush(rtc::LoggingSeverity severity, absl::string_view message, absl::string_view tag);
+
+    // Call f with the oldest record and remove it, return false if there is none ready.
+    // Must be called from the consumer thread only.
+    template <typename F>
+    bool TryPop(F&& f)
+    {
+        auto& slot = slots_[dequeuePos_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            // empty, or the producer of the slot has not finished writing
+            return false;
+        }
+
+        f(static_cast<const Record&>(slot.record));
+        slot.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        dequeuePos_++;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> enqueuePos_{0};
+    size_t dequeuePos_{0};
+};
+
+// Forward log messages to the loggable in ArkTS. Logging threads never block: records are queued in a ring and
+// delivered in batches on the js thread, they are dropped if the ring is full.
 class LogSink : public rtc::LogSink {
 public:
+    static constexpr size_t kDefaultCapacity = 1024;
+
     LogSink(napi_env env, Napi::Object logger);
     ~LogSink() override;
 
@@ -34,20 +84,23 @@ public:
     void OnLogMessage(absl::string_view msg, rtc::LoggingSeverity severity, const char* tag) override;
     void OnLogMessage(const rtc::LogLineRef& line) override;
 
+    uint64_t GetDroppedCount() const;
+
 protected:
-    struct DataType {
-        rtc::LoggingSeverity severity;
-        std::string msg;
-        std::string tag;
-    };
+    struct Context;
+    using DataType = void;
 
-    using Context = Napi::ObjectReference;
     static void CallJs(Napi::Env env, Napi::Function callback, Context* context, DataType*);
     using TSFN = Napi::TypedThreadSafeFunction<Context, DataType, CallJs>;
     using FinalizerDataType = void;
 
+    void Enqueue(rtc::LoggingSeverity severity, absl::string_view msg, absl::string_view tag);
+    static void Schedule(Context* context);
+
 private:
     TSFN tsfn_;
+    // owned by tsfn_, released in its finalizer
+    Context* context_{};
 };
 
 } // namespace webrtc
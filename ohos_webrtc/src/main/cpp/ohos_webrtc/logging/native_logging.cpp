@@ -31,6 +31,7 @@ const char kMethodNameEnableLogToDebugOutput[] = "enableLogToDebugOutput";
 const char kMethodNameEnableLogThreads[] = "enableLogThreads";
 const char kMethodNameEnableLogTimeStamps[] = "enableLogTimeStamps";
 const char kMethodNameLog[] = "log";
+const char kMethodNameGetDroppedLogCount[] = "getDroppedLogCount";
 
 struct StaticObjectContainer {
     std::unique_ptr<LogSink> logSink;
@@ -56,6 +57,7 @@ void NapiNativeLogging::Init(class Env env, Object exports)
             StaticMethod<&NapiNativeLogging::EnableLogThreads>(kMethodNameEnableLogThreads),
             StaticMethod<&NapiNativeLogging::EnableLogTimeStamps>(kMethodNameEnableLogTimeStamps),
             StaticMethod<&NapiNativeLogging::Log>(kMethodNameLog),
+            StaticMethod<&NapiNativeLogging::GetDroppedLogCount>(kMethodNameGetDroppedLogCount),
         });
     exports.Set(kClassName, func);
 
@@ -172,4 +174,14 @@ Napi::Value NapiNativeLogging::Log(const Napi::CallbackInfo& info)
     return info.Env().Undefined();
 }
 
+Napi::Value NapiNativeLogging::GetDroppedLogCount(const Napi::CallbackInfo& info)
+{
+    auto& logSink = GetStaticObjects().logSink;
+    if (!logSink) {
+        return Number::New(info.Env(), 0);
+    }
+
+    return Number::New(info.Env(), logSink->GetDroppedCount());
+}
+
 } // namespace webrtc
@@ -33,6 +33,7 @@ protected:
     static Napi::Value EnableLogThreads(const Napi::CallbackInfo& info);
     static Napi::Value EnableLogTimeStamps(const Napi::CallbackInfo& info);
     static Napi::Value Log(const Napi::CallbackInfo& info);
+    static Napi::Value GetDroppedLogCount(const Napi::CallbackInfo& info);
 
 private:
     static Napi::FunctionReference constructor_;
@@ -22,6 +22,7 @@
 
 #include "certificate.h"
 #include "data_channel.h"
+#include "data_channel_writer.h"
 #include "ice_candidate.h"
 #include "media_source.h"
 #include "media_stream.h"
@@ -81,6 +82,7 @@ static napi_value Init(napi_env env, napi_value exports)
     NapiAudioSource::Init(e, exp);
     NapiVideoSource::Init(e, exp);
     NapiDataChannel::Init(e, exp);
+    NapiDataChannelWriter::Init(e, exp);
     NapiMediaStream::Init(e, exp);
     NapiMediaStreamTrack::Init(e, exp);
     NapiNativeLogging::Init(e, exp);
@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ohos_audio_processing.h"
+#include "utils/marcos.h"
+
+#include "api/make_ref_counted.h"
+#include "modules/audio_processing/include/aec_dump.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+rtc::scoped_refptr<OhosAudioProcessing> OhosAudioProcessing::Create(const Config& config, uint32_t userFields)
+{
+    auto audioProcessing = AudioProcessingBuilder().SetConfig(config).Create();
+    if (!audioProcessing) {
+        RTC_LOG(LS_ERROR) << "Failed to create audio processing";
+        return nullptr;
+    }
+
+    auto ohosAudioProcessing = rtc::make_ref_counted<OhosAudioProcessing>(std::move(audioProcessing));
+    ohosAudioProcessing->ApplyUserConfig(config, userFields);
+    return ohosAudioProcessing;
+}
+
+OhosAudioProcessing::OhosAudioProcessing(rtc::scoped_refptr<AudioProcessing> audioProcessing)
+    : audioProcessing_(std::move(audioProcessing))
+{
+}
+
+void OhosAudioProcessing::ApplyUserConfig(const Config& config, uint32_t userFields)
+{
+    RTC_LOG(LS_INFO) << __FUNCTION__ << ": " << userFields;
+
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    userConfig_ = config;
+    userFields_ |= userFields;
+    audioProcessing_->ApplyConfig(MergeUserConfig(config));
+}
+
+void OhosAudioProcessing::ApplyConfig(const Config& config)
+{
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    audioProcessing_->ApplyConfig(MergeUserConfig(config));
+}
+
+OhosAudioProcessing::Config OhosAudioProcessing::MergeUserConfig(const Config& config) const
+{
+    Config merged = config;
+    if (userFields_ & kUserConfigFieldHighPassFilter) {
+        merged.high_pass_filter = userConfig_.high_pass_filter;
+    }
+    if (userFields_ & kUserConfigFieldEchoCanceller) {
+        merged.echo_canceller = userConfig_.echo_canceller;
+    }
+    if (userFields_ & kUserConfigFieldNoiseSuppression) {
+        merged.noise_suppression = userConfig_.noise_suppression;
+    }
+    if (userFields_ & kUserConfigFieldGainController1) {
+        merged.gain_controller1 = userConfig_.gain_controller1;
+    }
+    return merged;
+}
+
+int OhosAudioProcessing::Initialize()
+{
+    return audioProcessing_->Initialize();
+}
+
+int OhosAudioProcessing::Initialize(const ProcessingConfig& processing_config)
+{
+    return audioProcessing_->Initialize(processing_config);
+}
+
+int OhosAudioProcessing::proc_sample_rate_hz() const
+{
+    return audioProcessing_->proc_sample_rate_hz();
+}
+
+int OhosAudioProcessing::proc_split_sample_rate_hz() const
+{
+    return audioProcessing_->proc_split_sample_rate_hz();
+}
+
+size_t OhosAudioProcessing::num_input_channels() const
+{
+    return audioProcessing_->num_input_channels();
+}
+
+size_t OhosAudioProcessing::num_proc_channels() const
+{
+    return audioProcessing_->num_proc_channels();
+}
+
+size_t OhosAudioProcessing::num_output_channels() const
+{
+    return audioProcessing_->num_output_channels();
+}
+
+size_t OhosAudioProcessing::num_reverse_channels() const
+{
+    return audioProcessing_->num_reverse_channels();
+}
+
+void OhosAudioProcessing::set_output_will_be_muted(bool muted)
+{
+    audioProcessing_->set_output_will_be_muted(muted);
+}
+
+void OhosAudioProcessing::SetRuntimeSetting(RuntimeSetting setting)
+{
+    audioProcessing_->SetRuntimeSetting(setting);
+}
+
+bool OhosAudioProcessing::PostRuntimeSetting(RuntimeSetting setting)
+{
+    return audioProcessing_->PostRuntimeSetting(setting);
+}
+
+int OhosAudioProcessing::ProcessStream(
+    const int16_t* const src, const StreamConfig& input_config, const StreamConfig& output_config, int16_t* const dest)
+{
+    return audioProcessing_->ProcessStream(src, input_config, output_config, dest);
+}
+
+int OhosAudioProcessing::ProcessStream(
+    const float* const* src, const StreamConfig& input_config, const StreamConfig& output_config, float* const* dest)
+{
+    return audioProcessing_->ProcessStream(src, input_config, output_config, dest);
+}
+
+int OhosAudioProcessing::ProcessReverseStream(
+    const int16_t* const src, const StreamConfig& input_config, const StreamConfig& output_config, int16_t* const dest)
+{
+    return audioProcessing_->ProcessReverseStream(src, input_config, output_config, dest);
+}
+
+int OhosAudioProcessing::ProcessReverseStream(
+    const float* const* src, const StreamConfig& input_config, const StreamConfig& output_config, float* const* dest)
+{
+    return audioProcessing_->ProcessReverseStream(src, input_config, output_config, dest);
+}
+
+int OhosAudioProcessing::AnalyzeReverseStream(const float* const* data, const StreamConfig& reverse_config)
+{
+    return audioProcessing_->AnalyzeReverseStream(data, reverse_config);
+}
+
+bool OhosAudioProcessing::GetLinearAecOutput(rtc::ArrayView<std::array<float, 160>> linear_output) const
+{
+    return audioProcessing_->GetLinearAecOutput(linear_output);
+}
+
+void OhosAudioProcessing::set_stream_analog_level(int level)
+{
+    audioProcessing_->set_stream_analog_level(level);
+}
+
+int OhosAudioProcessing::recommended_stream_analog_level() const
+{
+    return audioProcessing_->recommended_stream_analog_level();
+}
+
+int OhosAudioProcessing::set_stream_delay_ms(int delay)
+{
+    return audioProcessing_->set_stream_delay_ms(delay);
+}
+
+int OhosAudioProcessing::stream_delay_ms() const
+{
+    return audioProcessing_->stream_delay_ms();
+}
+
+void OhosAudioProcessing::set_stream_key_pressed(bool key_pressed)
+{
+    audioProcessing_->set_stream_key_pressed(key_pressed);
+}
+
+bool OhosAudioProcessing::CreateAndAttachAecDump(
+    absl::string_view file_name, int64_t max_log_size_bytes, rtc::TaskQueue* worker_queue)
+{
+    return audioProcessing_->CreateAndAttachAecDump(file_name, max_log_size_bytes, worker_queue);
+}
+
+bool OhosAudioProcessing::CreateAndAttachAecDump(
+    FILE* handle, int64_t max_log_size_bytes, rtc::TaskQueue* worker_queue)
+{
+    return audioProcessing_->CreateAndAttachAecDump(handle, max_log_size_bytes, worker_queue);
+}
+
+void OhosAudioProcessing::AttachAecDump(std::unique_ptr<AecDump> aec_dump)
+{
+    audioProcessing_->AttachAecDump(std::move(aec_dump));
+}
+
+void OhosAudioProcessing::DetachAecDump()
+{
+    audioProcessing_->DetachAecDump();
+}
+
+AudioProcessingStats OhosAudioProcessing::GetStatistics()
+{
+    return audioProcessing_->GetStatistics();
+}
+
+AudioProcessingStats OhosAudioProcessing::GetStatistics(bool has_remote_tracks)
+{
+    return audioProcessing_->GetStatistics(has_remote_tracks);
+}
+
+AudioProcessing::Config OhosAudioProcessing::GetConfig() const
+{
+    return audioProcessing_->GetConfig();
+}
+
+} // namespace webrtc
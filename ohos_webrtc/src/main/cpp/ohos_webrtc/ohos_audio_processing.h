@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_OHOS_AUDIO_PROCESSING_H
+#define WEBRTC_OHOS_AUDIO_PROCESSING_H
+
+#include <cstdint>
+#include <mutex>
+
+#include "api/scoped_refptr.h"
+#include "modules/audio_processing/include/audio_processing.h"
+
+namespace webrtc {
+
+// AudioProcessing which keeps the stages configured by the application. The voice engine applies the audio options of
+// the sources to the config of the audio processing, when it is initialized and whenever the options of a send stream
+// change, which would override the echo canceller, the noise suppression, the gain controller 1 and the high-pass
+// filter set by the application. The groups set by the application are reapplied over every such config.
+class OhosAudioProcessing : public AudioProcessing {
+public:
+    // the groups of the config the voice engine writes
+    enum UserConfigField : uint32_t {
+        kUserConfigFieldNone = 0,
+        kUserConfigFieldHighPassFilter = 1 << 0,
+        kUserConfigFieldEchoCanceller = 1 << 1,
+        kUserConfigFieldNoiseSuppression = 1 << 2,
+        kUserConfigFieldGainController1 = 1 << 3,
+    };
+
+    static rtc::scoped_refptr<OhosAudioProcessing> Create(const Config& config, uint32_t userFields);
+
+    // Apply a config from the application, the given groups are kept from now on.
+    void ApplyUserConfig(const Config& config, uint32_t userFields);
+
+    // Keeps the groups set by the application, and applies the rest of the config.
+    void ApplyConfig(const Config& config) override;
+
+    int Initialize() override;
+    int Initialize(const ProcessingConfig& processing_config) override;
+    int proc_sample_rate_hz() const override;
+    int proc_split_sample_rate_hz() const override;
+    size_t num_input_channels() const override;
+    size_t num_proc_channels() const override;
+    size_t num_output_channels() const override;
+    size_t num_reverse_channels() const override;
+    void set_output_will_be_muted(bool muted) override;
+    void SetRuntimeSetting(RuntimeSetting setting) override;
+    bool PostRuntimeSetting(RuntimeSetting setting) override;
+    int ProcessStream(
+        const int16_t* const src, const StreamConfig& input_config, const StreamConfig& output_config,
+        int16_t* const dest) override;
+    int ProcessStream(
+        const float* const* src, const StreamConfig& input_config, const StreamConfig& output_config,
+        float* const* dest) override;
+    int ProcessReverseStream(
+        const int16_t* const src, const StreamConfig& input_config, const StreamConfig& output_config,
+        int16_t* const dest) override;
+    int ProcessReverseStream(
+        const float* const* src, const StreamConfig& input_config, const StreamConfig& output_config,
+        float* const* dest) override;
+    int AnalyzeReverseStream(const float* const* data, const StreamConfig& reverse_config) override;
+    bool GetLinearAecOutput(rtc::ArrayView<std::array<float, 160>> linear_output) const override;
+    void set_stream_analog_level(int level) override;
+    int recommended_stream_analog_level() const override;
+    int set_stream_delay_ms(int delay) override;
+    int stream_delay_ms() const override;
+    void set_stream_key_pressed(bool key_pressed) override;
+    bool CreateAndAttachAecDump(
+        absl::string_view file_name, int64_t max_log_size_bytes, rtc::TaskQueue* worker_queue) override;
+    bool CreateAndAttachAecDump(FILE* handle, int64_t max_log_size_bytes, rtc::TaskQueue* worker_queue) override;
+    void AttachAecDump(std::unique_ptr<AecDump> aec_dump) override;
+    void DetachAecDump() override;
+    AudioProcessingStats GetStatistics() override;
+    AudioProcessingStats GetStatistics(bool has_remote_tracks) override;
+    Config GetConfig() const override;
+
+protected:
+    explicit OhosAudioProcessing(rtc::scoped_refptr<AudioProcessing> audioProcessing);
+
+private:
+    Config MergeUserConfig(const Config& config) const;
+
+    const rtc::scoped_refptr<AudioProcessing> audioProcessing_;
+
+    mutable std::mutex mutex_;
+    Config userConfig_;
+    uint32_t userFields_{kUserConfigFieldNone};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_OHOS_AUDIO_PROCESSING_H
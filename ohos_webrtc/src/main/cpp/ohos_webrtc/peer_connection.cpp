@@ -36,6 +36,7 @@
 #include "utils/marcos.h"
 #include "async_work/async_worker_certificate.h"
 #include "async_work/async_worker_get_stats.h"
+#include "stats/stats_sampler.h"
 #include "audio_device/ohos_local_audio_source.h"
 
 namespace webrtc {
@@ -68,6 +69,17 @@ const char kEnumPeerConnectionStateDisconnected[] = "disconnected";
 const char kEnumPeerConnectionStateFailed[] = "failed";
 const char kEnumPeerConnectionStateClosed[] = "closed";
 
+const char kEnumStatsFormatObject[] = "object";
+const char kEnumStatsFormatBinary[] = "binary";
+
+const char kEnumStatsAggregationSum[] = "sum";
+const char kEnumStatsAggregationMin[] = "min";
+const char kEnumStatsAggregationMax[] = "max";
+const char kEnumStatsAggregationAverage[] = "average";
+
+const int kMinStatsSamplerIntervalMs = 10;
+const int64_t kMaxStatsSamplerCapacity = 1 << 20;
+
 const char kClassName[] = "RTCPeerConnection";
 
 const char kAttributeNameCanTrickleIceCandidates[] = "canTrickleIceCandidates";
@@ -82,6 +94,7 @@ const char kAttributeNameCurrentRemoteDescription[] = "currentRemoteDescription"
 const char kAttributeNamePendingLocalDescription[] = "pendingLocalDescription";
 const char kAttributeNamePendingRemoteDescription[] = "pendingRemoteDescription";
 const char kAttributeNameSctp[] = "sctp";
+const char kAttributeNameCoalescedEventCount[] = "coalescedEventCount";
 const char kAttributeNameOnConnectionStateChange[] = "onconnectionstatechange";
 const char kAttributeNameOnIceCandidate[] = "onicecandidate";
 const char kAttributeNameOnIceCandidateError[] = "onicecandidateerror";
@@ -91,6 +104,16 @@ const char kAttributeNameOnNegotiationNeeded[] = "onnegotiationneeded";
 const char kAttributeNameOnSignalingStateChange[] = "onsignalingstatechange";
 const char kAttributeNameOnTrack[] = "ontrack";
 const char kAttributeNameOnDataChannel[] = "ondatachannel";
+const char kAttributeNameDelta[] = "delta";
+const char kAttributeNameFormat[] = "format";
+const char kAttributeNameInterval[] = "interval";
+const char kAttributeNameCapacity[] = "capacity";
+const char kAttributeNameSeries[] = "series";
+const char kAttributeNameType[] = "type";
+const char kAttributeNameName[] = "name";
+const char kAttributeNameAggregation[] = "aggregation";
+const char kAttributeNameRate[] = "rate";
+const char kAttributeNameScale[] = "scale";
 
 const char kMethodNameAddTrack[] = "addTrack";
 const char kMethodNameRemoveTrack[] = "removeTrack";
@@ -109,6 +132,9 @@ const char kMethodNameSetConfiguration[] = "setConfiguration";
 const char kMethodNameAddTransceiver[] = "addTransceiver";
 const char kMethodNameClose[] = "close";
 const char kMethodNameGetStats[] = "getStats";
+const char kMethodNameStartStatsSampler[] = "startStatsSampler";
+const char kMethodNameStopStatsSampler[] = "stopStatsSampler";
+const char kMethodNameReadStatsSamples[] = "readStatsSamples";
 const char kMethodNameToJson[] = "toJSON";
 const char kMethodNameSetAudioRecording[] = "setAudioRecording";
 const char kMethodNameSetAudioPlayout[] = "setAudioPlayout";
@@ -304,6 +330,7 @@ void NapiPeerConnection::Init(class Env env, Object exports)
             InstanceAccessor<&NapiPeerConnection::GetPendingLocalDescription>(kAttributeNamePendingLocalDescription),
             InstanceAccessor<&NapiPeerConnection::GetPendingRemoteDescription>(kAttributeNamePendingRemoteDescription),
             InstanceAccessor<&NapiPeerConnection::GetSctp>(kAttributeNameSctp),
+            InstanceAccessor<&NapiPeerConnection::GetCoalescedEventCount>(kAttributeNameCoalescedEventCount),
             InstanceAccessor<&NapiPeerConnection::GetEventHandler, &NapiPeerConnection::SetEventHandler>(
                 kAttributeNameOnIceCandidate, napi_default, (void*)kEventIceCandidate),
             InstanceAccessor<&NapiPeerConnection::GetEventHandler, &NapiPeerConnection::SetEventHandler>(
@@ -339,6 +366,9 @@ void NapiPeerConnection::Init(class Env env, Object exports)
             InstanceMethod<&NapiPeerConnection::AddTransceiver>(kMethodNameAddTransceiver),
             InstanceMethod<&NapiPeerConnection::Close>(kMethodNameClose),
             InstanceMethod<&NapiPeerConnection::GetStats>(kMethodNameGetStats),
+            InstanceMethod<&NapiPeerConnection::StartStatsSampler>(kMethodNameStartStatsSampler),
+            InstanceMethod<&NapiPeerConnection::StopStatsSampler>(kMethodNameStopStatsSampler),
+            InstanceMethod<&NapiPeerConnection::ReadStatsSamples>(kMethodNameReadStatsSamples),
             InstanceMethod<&NapiPeerConnection::ToJson>(kMethodNameToJson),
             InstanceMethod<&NapiPeerConnection::SetAudioRecording>(kMethodNameSetAudioRecording),
             InstanceMethod<&NapiPeerConnection::SetAudioPlayout>(kMethodNameSetAudioPlayout),
@@ -398,6 +428,7 @@ NapiPeerConnection::NapiPeerConnection(const CallbackInfo& info) : NapiEventTarg
     }
 
     pc_ = result.MoveValue();
+    statsHistory_ = std::make_shared<StatsReportHistory>();
 }
 
 NapiPeerConnection::~NapiPeerConnection()
@@ -699,6 +730,13 @@ Napi::Value NapiPeerConnection::GetSctp(const Napi::CallbackInfo& info)
     return sctpTransport;
 }
 
+// readonly coalescedEventCount : number;
+Napi::Value NapiPeerConnection::GetCoalescedEventCount(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+    return Number::New(info.Env(), NapiEventTarget::GetCoalescedEventCount());
+}
+
 Napi::Value NapiPeerConnection::GetEventHandler(const Napi::CallbackInfo& info)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
@@ -973,7 +1011,7 @@ Napi::Value NapiPeerConnection::CreateDataChannel(const Napi::CallbackInfo& info
         }
 
         auto observer = std::make_unique<DataChannelObserverTemp>(result.value());
-        return NapiDataChannel::NewInstance(info.Env(), std::move(observer));
+        return NapiDataChannel::NewInstance(factory_, pc_, std::move(observer));
     }
 
     if (!info[1].IsObject()) {
@@ -991,7 +1029,7 @@ Napi::Value NapiPeerConnection::CreateDataChannel(const Napi::CallbackInfo& info
     }
 
     auto observer = std::make_unique<DataChannelObserverTemp>(result.value());
-    return NapiDataChannel::NewInstance(info.Env(), std::move(observer));
+    return NapiDataChannel::NewInstance(factory_, pc_, std::move(observer));
 }
 
 Napi::Value NapiPeerConnection::AddIceCandidate(const Napi::CallbackInfo& info)
@@ -1229,6 +1267,11 @@ Napi::Value NapiPeerConnection::Close(const Napi::CallbackInfo& info)
 {
     RTC_LOG(LS_VERBOSE) << __FUNCTION__;
 
+    if (statsSampler_) {
+        statsSampler_->Stop();
+        statsSampler_.reset();
+    }
+
     // Close操作可能耗时较长，放到信令线程执行以避免阻塞主线程
     pc_->signaling_thread()->PostTask([pc = pc_] {
         RTC_DLOG(LS_INFO) << "Do Close";
@@ -1254,7 +1297,45 @@ Napi::Value NapiPeerConnection::GetStats(const Napi::CallbackInfo& info)
         return deferred.Promise();
     }
 
-    auto napiTrack = NapiMediaStreamTrack::Unwrap(info[0].As<Object>());
+    auto jsOptions = info[0].As<Object>();
+    if (jsOptions.Has(kAttributeNameDelta) || jsOptions.Has(kAttributeNameFormat)) {
+        bool delta = false;
+        if (jsOptions.Has(kAttributeNameDelta)) {
+            auto jsDelta = jsOptions.Get(kAttributeNameDelta);
+            if (!jsDelta.IsBoolean()) {
+                auto deferred = Promise::Deferred::New(info.Env());
+                deferred.Reject(Error::New(info.Env(), "Invalid argument").Value());
+                return deferred.Promise();
+            }
+            delta = jsDelta.As<Boolean>().Value();
+        }
+
+        bool binary = false;
+        if (jsOptions.Has(kAttributeNameFormat)) {
+            auto jsFormat = jsOptions.Get(kAttributeNameFormat);
+            if (!jsFormat.IsString()) {
+                auto deferred = Promise::Deferred::New(info.Env());
+                deferred.Reject(Error::New(info.Env(), "Invalid argument").Value());
+                return deferred.Promise();
+            }
+
+            auto format = jsFormat.As<String>().Utf8Value();
+            if (format == kEnumStatsFormatBinary) {
+                binary = true;
+            } else if (format != kEnumStatsFormatObject) {
+                auto deferred = Promise::Deferred::New(info.Env());
+                deferred.Reject(Error::New(info.Env(), "Invalid argument").Value());
+                return deferred.Promise();
+            }
+        }
+
+        auto asyncWorker =
+            AsyncWorkerGetStats::Create(info.Env(), "GetStats", delta ? statsHistory_ : nullptr, binary);
+        pc_->GetStats(asyncWorker->GetCallback().get());
+        return asyncWorker->GetPromise();
+    }
+
+    auto napiTrack = NapiMediaStreamTrack::Unwrap(jsOptions);
     if (!napiTrack) {
         auto deferred = Promise::Deferred::New(info.Env());
         deferred.Reject(Error::New(info.Env(), "Invalid argument").Value());
@@ -1297,6 +1378,136 @@ Napi::Value NapiPeerConnection::GetStats(const Napi::CallbackInfo& info)
     return asyncWorker->GetPromise();
 }
 
+Napi::Value NapiPeerConnection::StartStatsSampler(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        NAPI_THROW(TypeError::New(info.Env(), "Invalid argument"), info.Env().Undefined());
+    }
+
+    auto jsOptions = info[0].As<Object>();
+
+    StatsSampler::Options options;
+    if (jsOptions.Has(kAttributeNameInterval)) {
+        auto jsInterval = jsOptions.Get(kAttributeNameInterval);
+        if (!jsInterval.IsNumber() || jsInterval.As<Number>().Int32Value() < kMinStatsSamplerIntervalMs) {
+            NAPI_THROW(RangeError::New(info.Env(), "Invalid interval"), info.Env().Undefined());
+        }
+        options.intervalMs = jsInterval.As<Number>().Int32Value();
+    }
+
+    if (jsOptions.Has(kAttributeNameCapacity)) {
+        auto jsCapacity = jsOptions.Get(kAttributeNameCapacity);
+        if (!jsCapacity.IsNumber() || jsCapacity.As<Number>().Int64Value() < 1 ||
+            jsCapacity.As<Number>().Int64Value() > kMaxStatsSamplerCapacity)
+        {
+            NAPI_THROW(RangeError::New(info.Env(), "Invalid capacity"), info.Env().Undefined());
+        }
+        options.capacity = jsCapacity.As<Number>().Int64Value();
+    }
+
+    auto jsSeries = jsOptions.Get(kAttributeNameSeries);
+    if (!jsSeries.IsArray() || jsSeries.As<Array>().Length() == 0) {
+        NAPI_THROW(TypeError::New(info.Env(), "Invalid series"), info.Env().Undefined());
+    }
+
+    auto jsSeriesArray = jsSeries.As<Array>();
+    for (uint32_t i = 0; i < jsSeriesArray.Length(); i++) {
+        Napi::Value jsItem = jsSeriesArray[i];
+        if (!jsItem.IsObject()) {
+            NAPI_THROW(TypeError::New(info.Env(), "Invalid series"), info.Env().Undefined());
+        }
+
+        auto jsSeriesItem = jsItem.As<Object>();
+        auto jsType = jsSeriesItem.Get(kAttributeNameType);
+        auto jsName = jsSeriesItem.Get(kAttributeNameName);
+        if (!jsType.IsString() || !jsName.IsString()) {
+            NAPI_THROW(TypeError::New(info.Env(), "Invalid series"), info.Env().Undefined());
+        }
+
+        StatsSampler::Series series;
+        series.type = jsType.As<String>().Utf8Value();
+        series.name = jsName.As<String>().Utf8Value();
+
+        if (jsSeriesItem.Has(kAttributeNameAggregation)) {
+            auto aggregation = jsSeriesItem.Get(kAttributeNameAggregation).ToString().Utf8Value();
+            if (aggregation == kEnumStatsAggregationSum) {
+                series.aggregation = StatsSampler::Aggregation::kSum;
+            } else if (aggregation == kEnumStatsAggregationMin) {
+                series.aggregation = StatsSampler::Aggregation::kMin;
+            } else if (aggregation == kEnumStatsAggregationMax) {
+                series.aggregation = StatsSampler::Aggregation::kMax;
+            } else if (aggregation == kEnumStatsAggregationAverage) {
+                series.aggregation = StatsSampler::Aggregation::kAverage;
+            } else {
+                NAPI_THROW(TypeError::New(info.Env(), "Invalid aggregation"), info.Env().Undefined());
+            }
+        }
+
+        if (jsSeriesItem.Has(kAttributeNameRate)) {
+            series.rate = jsSeriesItem.Get(kAttributeNameRate).ToBoolean().Value();
+        }
+
+        if (jsSeriesItem.Has(kAttributeNameScale)) {
+            auto jsScale = jsSeriesItem.Get(kAttributeNameScale);
+            if (!jsScale.IsNumber()) {
+                NAPI_THROW(TypeError::New(info.Env(), "Invalid scale"), info.Env().Undefined());
+            }
+            series.scale = jsScale.As<Number>().DoubleValue();
+        }
+
+        options.series.push_back(std::move(series));
+    }
+
+    // replace any running sampler, the samples of which are dropped
+    if (statsSampler_) {
+        statsSampler_->Stop();
+    }
+
+    statsSampler_ = std::make_shared<StatsSampler>(factory_->GetSignalingThread(), pc_, options);
+    statsSampler_->Start();
+
+    return info.Env().Undefined();
+}
+
+Napi::Value NapiPeerConnection::StopStatsSampler(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (statsSampler_) {
+        statsSampler_->Stop();
+    }
+
+    // samples can still be read after stopping
+    return info.Env().Undefined();
+}
+
+Napi::Value NapiPeerConnection::ReadStatsSamples(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (!statsSampler_) {
+        return Float64Array::New(info.Env(), 0);
+    }
+
+    size_t maxCount = statsSampler_->GetOptions().capacity;
+    if (info.Length() > 0 && !info[0].IsUndefined()) {
+        if (!info[0].IsNumber() || info[0].As<Number>().Int64Value() < 0) {
+            NAPI_THROW(TypeError::New(info.Env(), "Invalid argument"), info.Env().Undefined());
+        }
+        maxCount = std::min<size_t>(maxCount, info[0].As<Number>().Int64Value());
+    }
+
+    std::vector<double> samples;
+    statsSampler_->ReadSamples(maxCount, samples);
+
+    auto jsSamples = Float64Array::New(info.Env(), samples.size());
+    std::copy(samples.begin(), samples.end(), jsSamples.Data());
+
+    return jsSamples;
+}
+
 Napi::Value NapiPeerConnection::ToJson(const Napi::CallbackInfo& info)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
@@ -1454,30 +1665,32 @@ void NapiPeerConnection::OnStandardizedIceConnectionChange(PeerConnectionInterfa
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " newState=" << newState;
 
-    Dispatch(CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
-        RTC_DCHECK_EQ(this, &target);
+    DispatchCoalesced(
+        kEventIceConnectionStateChange, CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
+            RTC_DCHECK_EQ(this, &target);
 
-        auto env = target.Env();
-        Napi::HandleScope scope(env);
-        auto jsEvent = Object::New(env);
-        jsEvent.Set("type", String::New(env, kEventIceConnectionStateChange));
-        target.MakeCallback(kEventIceConnectionStateChange, {jsEvent});
-    }));
+            auto env = target.Env();
+            Napi::HandleScope scope(env);
+            auto jsEvent = Object::New(env);
+            jsEvent.Set("type", String::New(env, kEventIceConnectionStateChange));
+            target.MakeCallback(kEventIceConnectionStateChange, {jsEvent});
+        }));
 }
 
 void NapiPeerConnection::OnConnectionChange(PeerConnectionInterface::PeerConnectionState newState)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " newState=" << newState;
 
-    Dispatch(CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
-        RTC_DCHECK_EQ(this, &target);
+    DispatchCoalesced(
+        kEventConnectionStateChange, CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
+            RTC_DCHECK_EQ(this, &target);
 
-        auto env = target.Env();
-        Napi::HandleScope scope(env);
-        auto jsEvent = Object::New(env);
-        jsEvent.Set("type", String::New(env, kEventConnectionStateChange));
-        target.MakeCallback(kEventConnectionStateChange, {jsEvent});
-    }));
+            auto env = target.Env();
+            Napi::HandleScope scope(env);
+            auto jsEvent = Object::New(env);
+            jsEvent.Set("type", String::New(env, kEventConnectionStateChange));
+            target.MakeCallback(kEventConnectionStateChange, {jsEvent});
+        }));
 }
 
 void NapiPeerConnection::OnIceConnectionReceivingChange(bool receiving)
@@ -1489,15 +1702,16 @@ void NapiPeerConnection::OnIceGatheringChange(PeerConnectionInterface::IceGather
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__ << " newState=" << newState;
 
-    Dispatch(CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
-        RTC_DCHECK_EQ(this, &target);
+    DispatchCoalesced(
+        kEventIceGatheringStateChange, CallbackEvent<NapiPeerConnection>::Create([this](NapiPeerConnection& target) {
+            RTC_DCHECK_EQ(this, &target);
 
-        auto env = target.Env();
-        Napi::HandleScope scope(env);
-        auto jsEvent = Object::New(env);
-        jsEvent.Set("type", String::New(env, kEventIceGatheringStateChange));
-        target.MakeCallback(kEventIceGatheringStateChange, {jsEvent});
-    }));
+            auto env = target.Env();
+            Napi::HandleScope scope(env);
+            auto jsEvent = Object::New(env);
+            jsEvent.Set("type", String::New(env, kEventIceGatheringStateChange));
+            target.MakeCallback(kEventIceGatheringStateChange, {jsEvent});
+        }));
 }
 
 void NapiPeerConnection::OnIceSelectedCandidatePairChanged(const cricket::CandidatePairChangeEvent& event)
@@ -1532,7 +1746,8 @@ void NapiPeerConnection::OnDataChannel(rtc::scoped_refptr<DataChannelInterface>
         Napi::HandleScope scope(env);
         auto jsEvent = Object::New(env);
         jsEvent.Set("type", String::New(env, kEventDataChannel));
-        jsEvent.Set("channel", NapiDataChannel::NewInstance(env, std::unique_ptr<DataChannelObserverTemp>(obs)));
+        jsEvent.Set(
+            "channel", NapiDataChannel::NewInstance(factory_, pc_, std::unique_ptr<DataChannelObserverTemp>(obs)));
         target.MakeCallback(kEventDataChannel, {jsEvent});
     }));
 }
@@ -31,6 +31,8 @@
 namespace webrtc {
 
 class PeerConnectionFactoryWrapper;
+class StatsReportHistory;
+class StatsSampler;
 
 class NapiPeerConnection : public NapiEventTarget<NapiPeerConnection>, public PeerConnectionObserver {
 public:
@@ -56,6 +58,7 @@ protected:
     Napi::Value GetPendingLocalDescription(const Napi::CallbackInfo& info);
     Napi::Value GetPendingRemoteDescription(const Napi::CallbackInfo& info);
     Napi::Value GetSctp(const Napi::CallbackInfo& info);
+    Napi::Value GetCoalescedEventCount(const Napi::CallbackInfo& info);
 
     Napi::Value GetEventHandler(const Napi::CallbackInfo& info);
     void SetEventHandler(const Napi::CallbackInfo& info, const Napi::Value& value);
@@ -77,6 +80,9 @@ protected:
     Napi::Value AddTransceiver(const Napi::CallbackInfo& info);
     Napi::Value Close(const Napi::CallbackInfo& info);
     Napi::Value GetStats(const Napi::CallbackInfo& info);
+    Napi::Value StartStatsSampler(const Napi::CallbackInfo& info);
+    Napi::Value StopStatsSampler(const Napi::CallbackInfo& info);
+    Napi::Value ReadStatsSamples(const Napi::CallbackInfo& info);
     Napi::Value ToJson(const Napi::CallbackInfo& info);
     Napi::Value SetAudioRecording(const Napi::CallbackInfo& info);
     Napi::Value SetAudioPlayout(const Napi::CallbackInfo& info);
@@ -114,6 +120,11 @@ private:
     rtc::scoped_refptr<PeerConnectionInterface> pc_;
 
     Napi::ObjectReference sctpTransportRef_;
+
+    // previous report for getStats({delta: true})
+    std::shared_ptr<StatsReportHistory> statsHistory_;
+    // accessed on js thread only
+    std::shared_ptr<StatsSampler> statsSampler_;
 };
 
 } // namespace webrtc
@@ -32,6 +32,7 @@
 #include "camera/camera_capturer.h"
 #include "screen_capture/screen_capturer.h"
 #include "video/video_track_source.h"
+#include "video/frame_buffer_pool.h"
 #include "user_media/media_constraints_util.h"
 #include "video_encoder_factory.h"
 #include "video_decoder_factory.h"
@@ -44,6 +45,13 @@ using namespace Napi;
 
 const char kClassName[] = "PeerConnectionFactory";
 
+const char kAttributeNameHits[] = "hits";
+const char kAttributeNameMisses[] = "misses";
+const char kAttributeNameHighWater[] = "highWater";
+const char kAttributeNameBufferCount[] = "bufferCount";
+const char kAttributeNameInUseCount[] = "inUseCount";
+const char kAttributeNameByteCount[] = "byteCount";
+
 const char kMethodNameSetDefault[] = "setDefault";
 const char kMethodNameCreatePeerConnection[] = "createPeerConnection";
 const char kMethodNameCreateAudioSource[] = "createAudioSource";
@@ -52,6 +60,7 @@ const char kMethodNameCreateVideoSource[] = "createVideoSource";
 const char kMethodNameCreateVideoTrack[] = "createVideoTrack";
 const char kMethodNameStartAecDump[] = "startAecDump";
 const char kMethodNameStopAecDump[] = "stopAecDump";
+const char kMethodNameGetFrameBufferPoolStats[] = "getFrameBufferPoolStats";
 const char kMethodNameToJson[] = "toJSON";
 
 class NapiPeerConnectionFactoryOptions {
@@ -285,6 +294,7 @@ void NapiPeerConnectionFactory::Init(Napi::Env env, Object exports)
             InstanceMethod<&NapiPeerConnectionFactory::CreateVideoTrack>(kMethodNameCreateVideoTrack),
             InstanceMethod<&NapiPeerConnectionFactory::StartAecDump>(kMethodNameStartAecDump),
             InstanceMethod<&NapiPeerConnectionFactory::StopAecDump>(kMethodNameStopAecDump),
+            InstanceMethod<&NapiPeerConnectionFactory::GetFrameBufferPoolStats>(kMethodNameGetFrameBufferPoolStats),
             InstanceMethod<&NapiPeerConnectionFactory::ToJson>(kMethodNameToJson),
         });
     exports.Set(kClassName, func);
@@ -511,6 +521,23 @@ Napi::Value NapiPeerConnectionFactory::StopAecDump(const Napi::CallbackInfo& inf
     return info.Env().Undefined();
 }
 
+Napi::Value NapiPeerConnectionFactory::GetFrameBufferPoolStats(const Napi::CallbackInfo& info)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    auto stats = FrameBufferPool::GetDefault().GetStats();
+
+    auto result = Object::New(info.Env());
+    result.Set(kAttributeNameHits, Number::New(info.Env(), stats.hits));
+    result.Set(kAttributeNameMisses, Number::New(info.Env(), stats.misses));
+    result.Set(kAttributeNameHighWater, Number::New(info.Env(), stats.highWater));
+    result.Set(kAttributeNameBufferCount, Number::New(info.Env(), stats.bufferCount));
+    result.Set(kAttributeNameInUseCount, Number::New(info.Env(), stats.inUseCount));
+    result.Set(kAttributeNameByteCount, Number::New(info.Env(), stats.byteCount));
+
+    return result;
+}
+
 Napi::Value NapiPeerConnectionFactory::ToJson(const Napi::CallbackInfo& info)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
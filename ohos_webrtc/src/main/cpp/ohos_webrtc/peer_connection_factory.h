@@ -131,6 +131,7 @@ protected:
     Napi::Value CreateVideoTrack(const Napi::CallbackInfo& info);
     Napi::Value StartAecDump(const Napi::CallbackInfo& info);
     Napi::Value StopAecDump(const Napi::CallbackInfo& info);
+    Napi::Value GetFrameBufferPoolStats(const Napi::CallbackInfo& info);
 
     Napi::Value ToJson(const Napi::CallbackInfo& info);
 
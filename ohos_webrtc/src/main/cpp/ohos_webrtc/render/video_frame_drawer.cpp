@@ -37,18 +37,20 @@ void VideoFrameDrawer::DrawFrame(
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
+    // native frames backed by a native buffer are drawn from their I420 like the byte frames
+    auto textureBuffer = frame.is_texture() ? dynamic_cast<TextureBuffer*>(frame.video_frame_buffer().get()) : nullptr;
+
     renderMatrix_.Reset();
-    if (!frame.is_texture()) {
+    if (!textureBuffer) {
         renderMatrix_.PreScale(1.0f, -1.0f, 0.5f, 0.5f); // I420-frames are upside down
     }
     renderMatrix_.PreRotate(frame.rotation(), 0.5f, 0.5f);
     renderMatrix_.PreConcat(additionalRenderMatrix);
     RTC_DLOG(LS_VERBOSE) << "Render matrix: " << renderMatrix_;
 
-    if (frame.is_texture()) {
-        auto buffer = static_cast<TextureBuffer*>(frame.video_frame_buffer().get());
+    if (textureBuffer) {
         DrawTexture(
-            rtc::scoped_refptr<TextureBuffer>(buffer), drawer, renderMatrix_, frame.width(), frame.width(), viewportX,
+            rtc::scoped_refptr<TextureBuffer>(textureBuffer), drawer, renderMatrix_, frame.width(), frame.width(), viewportX,
             viewportY, viewportWidth, viewportHeight);
     } else {
         if (yuvTextures_.size() == 0) {
@@ -65,7 +67,12 @@ void VideoFrameDrawer::DrawFrame(
             }
         }
 
+        // a native buffer fails to convert when it cannot be mapped, or has an unsupported format
         auto buffer = frame.video_frame_buffer()->ToI420();
+        if (!buffer) {
+            RTC_LOG(LS_ERROR) << "Failed to convert frame buffer to I420, skip the frame";
+            return;
+        }
 
         const uint8_t* planes[] = {buffer->DataY(), buffer->DataU(), buffer->DataV()};
         int planeWidths[] = {buffer->StrideY(), buffer->StrideU(), buffer->StrideV()};
@@ -14,6 +14,7 @@
  */
 
 #include "yuv_converter.h"
+#include "../video/frame_buffer_pool.h"
 
 #include "api/video/i420_buffer.h"
 #include "rtc_base/logging.h"
@@ -327,143 +328,6 @@ std::unique_ptr<GlShader> GlConverterDrawer::CreateShader(ShaderType shaderType)
     return shader;
 }
 
-class LocalI420Buffer : public I420BufferInterface {
-public:
-    static rtc::scoped_refptr<LocalI420Buffer> Wrap(
-        std::unique_ptr<uint8_t, AlignedFreeDeleter> data, int width, int height, const uint8_t* dataY, int strideY,
-        const uint8_t* dataU, int strideU, const uint8_t* dataV, int strideV);
-
-    int width() const override;
-    int height() const override;
-
-    const uint8_t* DataY() const override;
-    const uint8_t* DataU() const override;
-    const uint8_t* DataV() const override;
-
-    int StrideY() const override;
-    int StrideU() const override;
-    int StrideV() const override;
-
-    rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
-        int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height) override;
-
-protected:
-    LocalI420Buffer(
-        std::unique_ptr<uint8_t, AlignedFreeDeleter> data, int width, int height, const uint8_t* dataY, int strideY,
-        const uint8_t* dataU, int strideU, const uint8_t* dataV, int strideV);
-
-    ~LocalI420Buffer() override = default;
-
-private:
-    const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
-    const int width_;
-    const int height_;
-    const uint8_t* dataY_;
-    const uint8_t* dataU_;
-    const uint8_t* dataV_;
-    const int strideY_;
-    const int strideU_;
-    const int strideV_;
-};
-
-rtc::scoped_refptr<LocalI420Buffer> LocalI420Buffer::Wrap(
-    std::unique_ptr<uint8_t, AlignedFreeDeleter> data, int width, int height, const uint8_t* dataY, int strideY,
-    const uint8_t* dataU, int strideU, const uint8_t* dataV, int strideV)
-{
-    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
-
-    if (dataY == nullptr || dataU == nullptr || dataV == nullptr) {
-        RTC_LOG(LS_ERROR) << "Data buffers cannot be null";
-        return nullptr;
-    }
-
-    return rtc::make_ref_counted<LocalI420Buffer>(
-        std::move(data), width, height, dataY, strideY, dataU, strideU, dataV, strideV);
-}
-
-LocalI420Buffer::LocalI420Buffer(
-    std::unique_ptr<uint8_t, AlignedFreeDeleter> data, int width, int height, const uint8_t* dataY, int strideY,
-    const uint8_t* dataU, int strideU, const uint8_t* dataV, int strideV)
-    : data_(std::move(data)),
-      width_(width),
-      height_(height),
-      dataY_(dataY),
-      dataU_(dataU),
-      dataV_(dataV),
-      strideY_(strideY),
-      strideU_(strideU),
-      strideV_(strideV)
-{
-}
-
-int LocalI420Buffer::width() const
-{
-    return width_;
-}
-
-int LocalI420Buffer::height() const
-{
-    return height_;
-}
-
-const uint8_t* LocalI420Buffer::DataY() const
-{
-    return dataY_;
-}
-
-const uint8_t* LocalI420Buffer::DataU() const
-{
-    return dataU_;
-}
-
-const uint8_t* LocalI420Buffer::DataV() const
-{
-    return dataV_;
-}
-
-int LocalI420Buffer::StrideY() const
-{
-    return strideY_;
-}
-
-int LocalI420Buffer::StrideU() const
-{
-    return strideU_;
-}
-
-int LocalI420Buffer::StrideV() const
-{
-    return strideV_;
-}
-
-rtc::scoped_refptr<VideoFrameBuffer> LocalI420Buffer::CropAndScale(
-    int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
-{
-    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
-
-    const uint8_t* srcY = DataY() + offset_y * StrideY() + offset_x;
-    const uint8_t* srcU = DataU() + offset_y / 2 * StrideU() + offset_x / 2;
-    const uint8_t* srcV = DataV() + offset_y / 2 * StrideV() + offset_x / 2;
-
-    auto newBuffer = I420Buffer::Create(scaled_width, scaled_height);
-
-    if (crop_width == scaled_width && crop_height == scaled_height) {
-        bool ret = libyuv::I420Copy(
-            srcY, StrideY(), srcU, StrideU(), srcV, StrideV(), newBuffer->MutableDataY(), newBuffer->StrideY(),
-            newBuffer->MutableDataU(), newBuffer->StrideU(), newBuffer->MutableDataV(), newBuffer->StrideV(),
-            scaled_width, scaled_height);
-        RTC_DCHECK_EQ(ret, 0) << "I420Copy failed";
-    } else {
-        bool ret = libyuv::I420Scale(
-            srcY, StrideY(), srcU, StrideU(), srcV, StrideV(), crop_width, crop_height, newBuffer->MutableDataY(),
-            newBuffer->StrideY(), newBuffer->MutableDataU(), newBuffer->StrideU(), newBuffer->MutableDataV(),
-            newBuffer->StrideV(), scaled_width, scaled_height, libyuv::kFilterBox);
-        RTC_DCHECK_EQ(ret, 0) << "I420Scale failed";
-    }
-
-    return newBuffer;
-}
-
 YuvConverter::YuvConverter()
     : drawer_(std::make_unique<GlConverterDrawer>()), frameDrawer_(std::make_unique<VideoFrameDrawer>())
 {
@@ -534,9 +398,14 @@ rtc::scoped_refptr<I420BufferInterface> YuvConverter::Convert(rtc::scoped_refptr
         textureBuffer, *drawer_, renderMatrix, frameWidth, frameHeight, viewportWidth / 2, frameHeight,
         viewportWidth / 2, uvHeight);
 
-    std::unique_ptr<uint8_t, AlignedFreeDeleter> i420Buffer(
-        static_cast<uint8_t*>(AlignedMalloc(stride * totalHeight, kBufferAlignment)));
-    glReadPixels(0, 0, frameBufferWidth_, frameBufferHeight_, GL_RGBA, GL_UNSIGNED_BYTE, i420Buffer.get());
+    const size_t readbackBufferSize = stride * totalHeight;
+    if (readbackBufferSize != readbackBufferSize_) {
+        readbackBuffer_.reset(static_cast<uint8_t*>(AlignedMalloc(readbackBufferSize, kBufferAlignment)));
+        readbackBufferSize_ = readbackBufferSize;
+    }
+
+    // stalls until the gpu has drawn the frame
+    glReadPixels(0, 0, frameBufferWidth_, frameBufferHeight_, GL_RGBA, GL_UNSIGNED_BYTE, readbackBuffer_.get());
     error = glGetError();
     if (error != GL_NO_ERROR) {
         RTC_LOG(LS_ERROR) << "Failed to call glReadPixels: " << error;
@@ -549,12 +418,19 @@ rtc::scoped_refptr<I420BufferInterface> YuvConverter::Convert(rtc::scoped_refptr
     int uPos = yPos + stride * frameHeight;
     int vPos = uPos + stride / 2;
 
-    const uint8_t* dataY = i420Buffer.get() + yPos;
-    const uint8_t* dataU = i420Buffer.get() + uPos;
-    const uint8_t* dataV = i420Buffer.get() + vPos;
+    const uint8_t* dataY = readbackBuffer_.get() + yPos;
+    const uint8_t* dataU = readbackBuffer_.get() + uPos;
+    const uint8_t* dataV = readbackBuffer_.get() + vPos;
+
+    // copy into a pooled buffer, as the readback buffer is reused for the next frame
+    auto i420Buffer = FrameBufferPool::GetDefault().CreateI420Buffer(frameWidth, frameHeight);
+    int ret = libyuv::I420Copy(
+        dataY, stride, dataU, stride, dataV, stride, i420Buffer->MutableDataY(), i420Buffer->StrideY(),
+        i420Buffer->MutableDataU(), i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(),
+        frameWidth, frameHeight);
+    RTC_DCHECK_EQ(ret, 0) << "I420Copy failed";
 
-    return LocalI420Buffer::Wrap(
-        std::move(i420Buffer), frameWidth, frameHeight, dataY, stride, dataU, stride, dataV, stride);
+    return i420Buffer;
 }
 
 bool YuvConverter::PrepareFrameBuffer(int width, int height)
@@ -19,7 +19,10 @@
 #include "video_frame_drawer.h"
 
 #include "api/video/video_frame_buffer.h"
+#include "rtc_base/memory/aligned_malloc.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace webrtc {
@@ -38,6 +41,10 @@ protected:
     bool PrepareFrameBuffer(int width, int height);
 
 private:
+    // the frame buffer is read back into this memory, reused for the next frames
+    std::unique_ptr<uint8_t, AlignedFreeDeleter> readbackBuffer_;
+    size_t readbackBufferSize_{0};
+
     int frameBufferWidth_{0};
     int frameBufferHeight_{0};
     unsigned int frameBufferId_{0};
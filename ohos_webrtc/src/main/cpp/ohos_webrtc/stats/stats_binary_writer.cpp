@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_binary_writer.h"
+
+#include <cstring>
+
+namespace webrtc {
+
+namespace {
+
+// all the supported targets are little-endian, so values are copied as they are
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buffer) : buffer_(buffer) {}
+
+    template <typename T>
+    void Write(T value)
+    {
+        auto offset = buffer_.size();
+        buffer_.resize(offset + sizeof(T));
+        memcpy(buffer_.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    void Align(size_t alignment)
+    {
+        buffer_.resize((buffer_.size() + alignment - 1) / alignment * alignment, 0);
+    }
+
+private:
+    std::vector<uint8_t>& buffer_;
+};
+
+} // namespace
+
+void StatsBinaryWriter::AddStats(
+    const RTCStats& stats, const std::vector<const RTCStatsMemberInterface*>& members,
+    const std::vector<std::pair<const char*, double>>& numbers)
+{
+    auto& group = groups_[Intern(stats.type())];
+    group.ids.push_back(Intern(stats.id()));
+    group.timestamps.push_back(stats.timestamp().ms<double>());
+
+    for (const auto* member : members) {
+        switch (member->type()) {
+            case RTCStatsMemberInterface::kBool:
+                AddValue(group, member->name(), kColumnKindBool, *member->cast_to<RTCStatsMember<bool>>() ? 1 : 0);
+                break;
+            case RTCStatsMemberInterface::kInt32:
+                AddValue(group, member->name(), kColumnKindNumber, *member->cast_to<RTCStatsMember<int32_t>>());
+                break;
+            case RTCStatsMemberInterface::kUint32:
+                AddValue(group, member->name(), kColumnKindNumber, *member->cast_to<RTCStatsMember<uint32_t>>());
+                break;
+            case RTCStatsMemberInterface::kInt64:
+                AddValue(group, member->name(), kColumnKindNumber, *member->cast_to<RTCStatsMember<int64_t>>());
+                break;
+            case RTCStatsMemberInterface::kUint64:
+                AddValue(group, member->name(), kColumnKindNumber, *member->cast_to<RTCStatsMember<uint64_t>>());
+                break;
+            case RTCStatsMemberInterface::kDouble:
+                AddValue(group, member->name(), kColumnKindNumber, *member->cast_to<RTCStatsMember<double>>());
+                break;
+            case RTCStatsMemberInterface::kString:
+                AddValue(group, member->name(), kColumnKindString, Intern(member->ValueToString()));
+                break;
+            default:
+                AddValue(group, member->name(), kColumnKindJson, Intern(member->ValueToJson()));
+                break;
+        }
+    }
+
+    for (const auto& number : numbers) {
+        AddValue(group, number.first, kColumnKindNumber, number.second);
+    }
+}
+
+void StatsBinaryWriter::AddRemoved(const std::string& id)
+{
+    removed_.push_back(Intern(id));
+}
+
+std::vector<uint8_t> StatsBinaryWriter::Finish(uint16_t flags)
+{
+    std::vector<uint8_t> buffer;
+    ByteWriter writer(buffer);
+
+    writer.Write<uint32_t>(kMagic);
+    writer.Write<uint16_t>(kVersion);
+    writer.Write<uint16_t>(flags);
+    writer.Write<uint32_t>(strings_.size());
+    writer.Write<uint32_t>(groups_.size());
+    writer.Write<uint32_t>(removed_.size());
+    writer.Write<uint32_t>(0);
+
+    for (const auto& str : strings_) {
+        writer.Write<uint32_t>(str.size());
+        writer.WriteBytes(str.data(), str.size());
+    }
+    writer.Align(sizeof(uint32_t));
+
+    for (auto index : removed_) {
+        writer.Write<uint32_t>(index);
+    }
+
+    for (const auto& [type, group] : groups_) {
+        const auto rowCount = group.ids.size();
+
+        writer.Align(sizeof(double));
+        writer.Write<uint32_t>(type);
+        writer.Write<uint32_t>(rowCount);
+        writer.Write<uint32_t>(group.columns.size());
+        writer.Write<uint32_t>(0);
+
+        writer.WriteBytes(group.ids.data(), rowCount * sizeof(uint32_t));
+        writer.Align(sizeof(double));
+        writer.WriteBytes(group.timestamps.data(), rowCount * sizeof(double));
+
+        std::vector<uint8_t> presence;
+        std::vector<double> values;
+        for (const auto& [name, column] : group.columns) {
+            presence.assign((rowCount + 7) / 8, 0);
+            values.assign(rowCount, 0);
+            for (const auto& [row, value] : column.values) {
+                presence[row / 8] |= 1 << (row % 8);
+                values[row] = value;
+            }
+
+            writer.Write<uint32_t>(name);
+            writer.Write<uint8_t>(column.kind);
+            writer.Write<uint8_t>(0);
+            writer.Write<uint16_t>(0);
+            writer.WriteBytes(presence.data(), presence.size());
+            writer.Align(sizeof(double));
+            writer.WriteBytes(values.data(), values.size() * sizeof(double));
+        }
+    }
+
+    return buffer;
+}
+
+uint32_t StatsBinaryWriter::Intern(const std::string& str)
+{
+    auto it = stringIndices_.find(str);
+    if (it != stringIndices_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = strings_.size();
+    strings_.push_back(str);
+    stringIndices_.emplace(str, index);
+    return index;
+}
+
+void StatsBinaryWriter::AddValue(Group& group, const std::string& name, ColumnKind kind, double value)
+{
+    auto nameIndex = Intern(name);
+    auto it = group.columnIndices.find(nameIndex);
+    if (it == group.columnIndices.end()) {
+        it = group.columnIndices.emplace(nameIndex, group.columns.size()).first;
+        group.columns.emplace_back(nameIndex, Column{kind, {}});
+    }
+
+    // the row being added is always the last one of the group
+    group.columns[it->second].second.values.emplace_back(group.ids.size() - 1, value);
+}
+
+} // namespace webrtc
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_STATS_STATS_BINARY_WRITER_H
+#define WEBRTC_STATS_STATS_BINARY_WRITER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "api/stats/rtc_stats_report.h"
+
+namespace webrtc {
+
+// Serializes stats into one little-endian buffer, with a string table shared by the whole buffer and the stats
+// grouped by type into columns. All offsets below are relative to the start of the buffer.
+//
+//   header        uint32 magic 'RTCS', uint16 version, uint16 flags,
+//                 uint32 stringCount, uint32 groupCount, uint32 removedCount, uint32 reserved
+//   strings       stringCount x (uint32 byteLength, utf-8 bytes), padded to 4
+//   removed       removedCount x uint32 string index of the removed stats id
+//   groups        groupCount x group, each one aligned to 8
+//
+//   group         uint32 type, uint32 rowCount, uint32 columnCount, uint32 reserved
+//                 rowCount x uint32 string index of the stats id, padded to 8
+//                 rowCount x float64 timestamp in ms
+//                 columnCount x column
+//
+//   column        uint32 name, uint8 kind, 3 bytes reserved
+//                 ceil(rowCount / 8) bytes of presence bits, row i is bit (i % 8) of byte (i / 8), padded to 8
+//                 rowCount x float64 value, 0 for absent rows
+//
+// Values of number columns are the numbers themselves, 64-bit integers beyond 2^53 lose precision as in ArkTS.
+// Values of bool columns are 0 or 1, values of string and json columns are string indices.
+class StatsBinaryWriter {
+public:
+    static constexpr uint32_t kMagic = 0x53435452;
+    static constexpr uint16_t kVersion = 1;
+
+    enum Flags : uint16_t {
+        kFlagDelta = 1 << 0,
+    };
+
+    enum ColumnKind : uint8_t {
+        kColumnKindNumber = 0,
+        kColumnKindBool = 1,
+        kColumnKindString = 2,
+        // sequences and maps, as a json string
+        kColumnKindJson = 3,
+    };
+
+    void AddStats(
+        const RTCStats& stats, const std::vector<const RTCStatsMemberInterface*>& members,
+        const std::vector<std::pair<const char*, double>>& numbers);
+    void AddRemoved(const std::string& id);
+
+    std::vector<uint8_t> Finish(uint16_t flags);
+
+private:
+    struct Column {
+        ColumnKind kind;
+        std::vector<std::pair<uint32_t, double>> values;
+    };
+
+    struct Group {
+        std::vector<uint32_t> ids;
+        std::vector<double> timestamps;
+        // name -> column, in the order of first appearance
+        std::vector<std::pair<uint32_t, Column>> columns;
+        std::unordered_map<uint32_t, size_t> columnIndices;
+    };
+
+    uint32_t Intern(const std::string& str);
+    void AddValue(Group& group, const std::string& name, ColumnKind kind, double value);
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> stringIndices_;
+    std::vector<uint32_t> removed_;
+    std::map<uint32_t, Group> groups_;
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_STATS_STATS_BINARY_WRITER_H
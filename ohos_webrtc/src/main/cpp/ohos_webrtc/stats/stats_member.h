@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_STATS_STATS_MEMBER_H
+#define WEBRTC_STATS_STATS_MEMBER_H
+
+#include <cstring>
+#include <vector>
+
+#include "api/stats/rtc_stats.h"
+
+namespace webrtc {
+
+// Get the value of a defined numeric member.
+inline bool StatsMemberToDouble(const RTCStatsMemberInterface* member, double& value)
+{
+    if (!member || !member->is_defined()) {
+        return false;
+    }
+
+    switch (member->type()) {
+        case RTCStatsMemberInterface::kInt32:
+            value = *member->cast_to<RTCStatsMember<int32_t>>();
+            return true;
+        case RTCStatsMemberInterface::kUint32:
+            value = *member->cast_to<RTCStatsMember<uint32_t>>();
+            return true;
+        case RTCStatsMemberInterface::kInt64:
+            value = *member->cast_to<RTCStatsMember<int64_t>>();
+            return true;
+        case RTCStatsMemberInterface::kUint64:
+            value = *member->cast_to<RTCStatsMember<uint64_t>>();
+            return true;
+        case RTCStatsMemberInterface::kDouble:
+            value = *member->cast_to<RTCStatsMember<double>>();
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+inline const RTCStatsMemberInterface*
+FindStatsMember(const std::vector<const RTCStatsMemberInterface*>& members, const char* name)
+{
+    for (const auto* member : members) {
+        if (member && strcmp(member->name(), name) == 0) {
+            return member;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace webrtc
+
+#endif // WEBRTC_STATS_STATS_MEMBER_H
@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_sampler.h"
+#include "stats_member.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+
+#include "../utils/marcos.h"
+
+namespace webrtc {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+class StatsSampler::Callback : public RTCStatsCollectorCallback {
+public:
+    explicit Callback(std::weak_ptr<StatsSampler> sampler) : sampler_(std::move(sampler)) {}
+
+protected:
+    void OnStatsDelivered(const rtc::scoped_refptr<const RTCStatsReport>& report) override
+    {
+        if (auto sampler = sampler_.lock()) {
+            sampler->OnStatsDelivered(report);
+        }
+    }
+
+private:
+    std::weak_ptr<StatsSampler> sampler_;
+};
+
+StatsSampler::StatsSampler(
+    rtc::Thread* signalingThread, rtc::scoped_refptr<PeerConnectionInterface> pc, const Options& options)
+    : signalingThread_(signalingThread), pc_(std::move(pc)), options_(options),
+      lastRawValues_(options.series.size(), kNaN), samples_(std::max<size_t>(options.capacity, 1) * GetStride(), kNaN)
+{
+}
+
+StatsSampler::~StatsSampler()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+}
+
+void StatsSampler::Start()
+{
+    auto weakThis = weak_from_this();
+    signalingThread_->PostTask([weakThis] {
+        auto self = weakThis.lock();
+        if (!self || self->repeatingTask_.Running()) {
+            return;
+        }
+
+        self->repeatingTask_ = RepeatingTaskHandle::Start(self->signalingThread_, [weakThis] {
+            auto self = weakThis.lock();
+            if (!self) {
+                return TimeDelta::PlusInfinity();
+            }
+
+            self->Sample();
+            return TimeDelta::Millis(self->options_.intervalMs);
+        });
+    });
+}
+
+void StatsSampler::Stop()
+{
+    // the repeating task must be stopped on the thread it runs on
+    signalingThread_->PostTask([self = shared_from_this()] { self->repeatingTask_.Stop(); });
+}
+
+size_t StatsSampler::GetSampleCount() const
+{
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    return sampleCount_;
+}
+
+size_t StatsSampler::ReadSamples(size_t maxCount, std::vector<double>& out) const
+{
+    const size_t stride = GetStride();
+    const size_t capacity = samples_.size() / stride;
+
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = std::min(maxCount, sampleCount_);
+    out.resize(count * stride);
+
+    // the oldest requested sample, rows may wrap around the end of the ring
+    size_t row = (writeIndex_ + capacity - count) % capacity;
+    size_t firstPart = std::min(count, capacity - row);
+    std::copy_n(samples_.begin() + row * stride, firstPart * stride, out.begin());
+    std::copy_n(samples_.begin(), (count - firstPart) * stride, out.begin() + firstPart * stride);
+
+    return count;
+}
+
+void StatsSampler::Sample()
+{
+    RTC_DCHECK_RUN_ON(signalingThread_);
+
+    // skip this round if the previous stats are not delivered yet
+    if (pending_) {
+        return;
+    }
+
+    pending_ = true;
+    pc_->GetStats(rtc::make_ref_counted<Callback>(weak_from_this()).get());
+}
+
+void StatsSampler::OnStatsDelivered(const rtc::scoped_refptr<const RTCStatsReport>& report)
+{
+    RTC_DCHECK_RUN_ON(signalingThread_);
+
+    pending_ = false;
+    if (!repeatingTask_.Running()) {
+        return;
+    }
+
+    const size_t stride = GetStride();
+    std::vector<double> row(stride, kNaN);
+    double timestampMs = report->timestamp().ms<double>();
+    row[0] = timestampMs;
+
+    for (size_t i = 0; i < options_.series.size(); i++) {
+        const auto& series = options_.series[i];
+
+        double result = kNaN;
+        size_t count = 0;
+        for (const auto& stats : *report) {
+            double value = 0;
+            if (series.type != stats.type() ||
+                !StatsMemberToDouble(FindStatsMember(stats.Members(), series.name.c_str()), value))
+            {
+                continue;
+            }
+
+            if (count == 0) {
+                result = value;
+            } else {
+                switch (series.aggregation) {
+                    case Aggregation::kMin:
+                        result = std::min(result, value);
+                        break;
+                    case Aggregation::kMax:
+                        result = std::max(result, value);
+                        break;
+                    default:
+                        result += value;
+                        break;
+                }
+            }
+            count++;
+        }
+
+        if (count > 0 && series.aggregation == Aggregation::kAverage) {
+            result /= count;
+        }
+
+        if (series.rate) {
+            double elapsed = (timestampMs - lastTimestampMs_) / 1000;
+            double raw = result;
+            result = kNaN;
+            // NaN of the last value propagates, a counter going backwards means the streams have changed
+            if (elapsed > 0 && raw >= lastRawValues_[i]) {
+                result = (raw - lastRawValues_[i]) / elapsed;
+            }
+            lastRawValues_[i] = raw;
+        }
+
+        row[i + 1] = std::isnan(result) ? kNaN : result * series.scale;
+    }
+    lastTimestampMs_ = timestampMs;
+
+    const size_t capacity = samples_.size() / stride;
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    std::copy(row.begin(), row.end(), samples_.begin() + writeIndex_ * stride);
+    writeIndex_ = (writeIndex_ + 1) % capacity;
+    sampleCount_ = std::min(sampleCount_ + 1, capacity);
+}
+
+} // namespace webrtc
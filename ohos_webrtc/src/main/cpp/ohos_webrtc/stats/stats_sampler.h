@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_STATS_STATS_SAMPLER_H
+#define WEBRTC_STATS_STATS_SAMPLER_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/peer_connection_interface.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "rtc_base/thread.h"
+
+namespace webrtc {
+
+// Periodically collects stats of a peer connection on the signaling thread, and keeps a configured set of numeric
+// series in a fixed-size ring buffer. Each sample is a row of the timestamp in ms followed by one value per series,
+// NaN if the value is not available.
+class StatsSampler : public std::enable_shared_from_this<StatsSampler> {
+public:
+    enum class Aggregation {
+        kSum,
+        kMin,
+        kMax,
+        kAverage,
+    };
+
+    struct Series {
+        // stats type, such as 'outbound-rtp'
+        std::string type;
+        // member name, such as 'bytesSent'
+        std::string name;
+        // how to combine the values when there are several stats of the type
+        Aggregation aggregation = Aggregation::kSum;
+        // per-second rate of the value between two samples, such as bitrate from bytesSent
+        bool rate = false;
+        // applied after the rate, such as 8 for bits from bytes
+        double scale = 1.0;
+    };
+
+    struct Options {
+        int intervalMs = 1000;
+        size_t capacity = 600;
+        std::vector<Series> series;
+    };
+
+    StatsSampler(
+        rtc::Thread* signalingThread, rtc::scoped_refptr<PeerConnectionInterface> pc, const Options& options);
+    ~StatsSampler();
+
+    void Start();
+    void Stop();
+
+    const Options& GetOptions() const
+    {
+        return options_;
+    }
+
+    // number of values in a sample row
+    size_t GetStride() const
+    {
+        return options_.series.size() + 1;
+    }
+
+    size_t GetSampleCount() const;
+
+    // Copy at most maxCount latest samples into out, oldest first, and return the number of samples copied.
+    size_t ReadSamples(size_t maxCount, std::vector<double>& out) const;
+
+private:
+    class Callback;
+
+    void Sample();
+    void OnStatsDelivered(const rtc::scoped_refptr<const RTCStatsReport>& report);
+
+private:
+    rtc::Thread* const signalingThread_;
+    const rtc::scoped_refptr<PeerConnectionInterface> pc_;
+    const Options options_;
+
+    // accessed on signaling thread only
+    RepeatingTaskHandle repeatingTask_;
+    bool pending_{false};
+    std::vector<double> lastRawValues_;
+    double lastTimestampMs_{0};
+
+    mutable std::mutex mutex_;
+    std::vector<double> samples_;
+    size_t writeIndex_{0};
+    size_t sampleCount_{0};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_STATS_STATS_SAMPLER_H
@@ -0,0 +1,270 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_buffer_pool.h"
+#include "../utils/marcos.h"
+
+#include "api/make_ref_counted.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Whether the pool holds the only reference. The buffers are created by make_ref_counted, which wraps them in a
+// RefCountedObject, as VideoFrameBufferPool of webrtc does.
+bool HasOneRef(const rtc::scoped_refptr<VideoFrameBuffer>& buffer)
+{
+    switch (buffer->type()) {
+        case VideoFrameBuffer::Type::kI420:
+            return static_cast<rtc::RefCountedObject<I420Buffer>*>(buffer.get())->HasOneRef();
+        case VideoFrameBuffer::Type::kNV12:
+            return static_cast<rtc::RefCountedObject<NV12Buffer>*>(buffer.get())->HasOneRef();
+        default:
+            RTC_DCHECK_NOTREACHED();
+            return false;
+    }
+}
+
+// the sizes I420Buffer and NV12Buffer allocate
+size_t GetBufferBytes(VideoFrameBuffer::Type type, int width, int height)
+{
+    const size_t chromaHeight = (height + 1) / 2;
+    if (type == VideoFrameBuffer::Type::kNV12) {
+        return static_cast<size_t>(width) * height + static_cast<size_t>(width + width % 2) * chromaHeight;
+    }
+
+    return static_cast<size_t>(width) * height + static_cast<size_t>((width + 1) / 2) * chromaHeight * 2;
+}
+
+} // namespace
+
+FrameBufferPool& FrameBufferPool::GetDefault()
+{
+    static FrameBufferPool _pool;
+    return _pool;
+}
+
+FrameBufferPool::FrameBufferPool(size_t maxBuffersPerSize, size_t maxSizes, size_t maxBytes, int64_t maxIdleMs)
+    : maxBuffersPerSize_(maxBuffersPerSize), maxSizes_(maxSizes), maxBytes_(maxBytes), maxIdleMs_(maxIdleMs)
+{
+}
+
+FrameBufferPool::~FrameBufferPool() = default;
+
+rtc::scoped_refptr<I420Buffer> FrameBufferPool::CreateI420Buffer(int width, int height)
+{
+    const Key key{VideoFrameBuffer::Type::kI420, width, height};
+
+    bool pooled = false;
+    auto existing = GetExistingBuffer(key, &pooled);
+    if (existing) {
+        return rtc::scoped_refptr<I420Buffer>(static_cast<I420Buffer*>(existing.get()));
+    }
+
+    // allocate outside of the lock
+    auto buffer = rtc::make_ref_counted<I420Buffer>(width, height);
+    if (pooled) {
+        AddBuffer(key, buffer);
+    }
+
+    return buffer;
+}
+
+rtc::scoped_refptr<NV12Buffer> FrameBufferPool::CreateNV12Buffer(int width, int height)
+{
+    const Key key{VideoFrameBuffer::Type::kNV12, width, height};
+
+    bool pooled = false;
+    auto existing = GetExistingBuffer(key, &pooled);
+    if (existing) {
+        return rtc::scoped_refptr<NV12Buffer>(static_cast<NV12Buffer*>(existing.get()));
+    }
+
+    auto buffer = rtc::make_ref_counted<NV12Buffer>(width, height);
+    if (pooled) {
+        AddBuffer(key, buffer);
+    }
+
+    return buffer;
+}
+
+FrameBufferPool::Stats FrameBufferPool::GetStats() const
+{
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.highWater = highWater_.load(std::memory_order_relaxed);
+
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    stats.bufferCount = bufferCount_;
+    stats.byteCount = byteCount_;
+    for (const auto& [key, entry] : entries_) {
+        for (const auto& buffer : entry.buffers) {
+            if (!HasOneRef(buffer)) {
+                stats.inUseCount++;
+            }
+        }
+    }
+
+    return stats;
+}
+
+void FrameBufferPool::Release()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        ReleaseFreeBuffers(it->second);
+        if (it->second.buffers.empty()) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> FrameBufferPool::GetExistingBuffer(const Key& key, bool* pooled)
+{
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+
+    const int64_t nowMs = rtc::TimeMillis();
+    ReleaseIdle(nowMs);
+
+    auto& entry = entries_[key];
+    entry.lastUse = ++useCount_;
+    entry.lastUseMs = nowMs;
+
+    for (const auto& buffer : entry.buffers) {
+        // nobody else can take a reference while the mutex is held
+        if (HasOneRef(buffer)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return buffer;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    *pooled = entry.buffers.size() < maxBuffersPerSize_;
+    if (!*pooled) {
+        RTC_LOG(LS_WARNING) << "Too many buffers in use: " << std::get<1>(key) << "x" << std::get<2>(key);
+    }
+
+    Trim();
+
+    return nullptr;
+}
+
+void FrameBufferPool::AddBuffer(const Key& key, rtc::scoped_refptr<VideoFrameBuffer> buffer)
+{
+    UNUSED std::lock_guard<std::mutex> lock(mutex_);
+
+    // the entry may have been trimmed while the buffer was allocated
+    auto& entry = entries_[key];
+    entry.lastUse = ++useCount_;
+    entry.lastUseMs = rtc::TimeMillis();
+    entry.bufferBytes = GetBufferBytes(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+
+    // the buffer stays outside of the pool when the buffers in use already take all the bytes
+    if (!ReserveBytes(entry.bufferBytes)) {
+        RTC_LOG(LS_WARNING) << "Too many bytes in use: " << byteCount_;
+        return;
+    }
+
+    entry.buffers.push_back(std::move(buffer));
+    bufferCount_++;
+    byteCount_ += entry.bufferBytes;
+
+    if (bufferCount_ > highWater_.load(std::memory_order_relaxed)) {
+        highWater_.store(bufferCount_, std::memory_order_relaxed);
+    }
+}
+
+void FrameBufferPool::Trim()
+{
+    while (entries_.size() > maxSizes_) {
+        auto oldest = entries_.begin();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+
+        // the buffers still in use are freed with their last reference, instead of returning to the pool
+        RTC_DLOG(LS_INFO) << "Purge buffers of " << std::get<1>(oldest->first) << "x" << std::get<2>(oldest->first);
+        bufferCount_ -= oldest->second.buffers.size();
+        byteCount_ -= oldest->second.buffers.size() * oldest->second.bufferBytes;
+        entries_.erase(oldest);
+    }
+}
+
+void FrameBufferPool::ReleaseIdle(int64_t nowMs)
+{
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (nowMs - it->second.lastUseMs >= maxIdleMs_) {
+            ReleaseFreeBuffers(it->second);
+        }
+
+        if (it->second.buffers.empty()) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool FrameBufferPool::ReserveBytes(size_t bytes)
+{
+    while (byteCount_ + bytes > maxBytes_) {
+        Entry* oldest = nullptr;
+        for (auto& [key, entry] : entries_) {
+            if (oldest && entry.lastUse >= oldest->lastUse) {
+                continue;
+            }
+            for (const auto& buffer : entry.buffers) {
+                if (HasOneRef(buffer)) {
+                    oldest = &entry;
+                    break;
+                }
+            }
+        }
+
+        if (!oldest) {
+            return false;
+        }
+
+        RTC_DLOG(LS_INFO) << "Release free buffers for " << bytes << " bytes";
+        ReleaseFreeBuffers(*oldest);
+    }
+
+    return true;
+}
+
+void FrameBufferPool::ReleaseFreeBuffers(Entry& entry)
+{
+    for (auto it = entry.buffers.begin(); it != entry.buffers.end();) {
+        if (HasOneRef(*it)) {
+            it = entry.buffers.erase(it);
+            bufferCount_--;
+            byteCount_ -= entry.bufferBytes;
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace webrtc
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_VIDEO_FRAME_BUFFER_POOL_H
+#define WEBRTC_VIDEO_FRAME_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "api/scoped_refptr.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
+#include "api/video/video_frame_buffer.h"
+
+namespace webrtc {
+
+// Thread-safe pool of I420/NV12 buffers keyed by the format and the resolution, after VideoFrameBufferPool of webrtc.
+// The pool keeps a reference to every buffer it created, a buffer is free again once all the other references are
+// dropped. Unlike VideoFrameBufferPool, a change of resolution does not purge the other sizes, so that the capture,
+// decode and scaling paths can share one pool. The free buffers are bounded in bytes, and dropped once their size has
+// not been requested for a while.
+class FrameBufferPool {
+public:
+    static constexpr size_t kMaxBuffersPerSize_Default = 16;
+    static constexpr size_t kMaxSizes_Default = 8;
+    // about twenty 1080p I420 buffers
+    static constexpr size_t kMaxBytes_Default = 64 * 1024 * 1024;
+    static constexpr int64_t kMaxIdleMs_Default = 10000;
+
+    struct Stats {
+        // requests served by a free buffer
+        uint64_t hits{0};
+        // requests that allocated a buffer, pooled or not
+        uint64_t misses{0};
+        // the most buffers held by the pool at the same time
+        uint64_t highWater{0};
+        // the buffers held by the pool now, and how many of them are in use
+        uint64_t bufferCount{0};
+        uint64_t inUseCount{0};
+        // the memory of the buffers held by the pool
+        uint64_t byteCount{0};
+    };
+
+    // shared by capture, decode and software scaling
+    static FrameBufferPool& GetDefault();
+
+    explicit FrameBufferPool(size_t maxBuffersPerSize = kMaxBuffersPerSize_Default,
+        size_t maxSizes = kMaxSizes_Default, size_t maxBytes = kMaxBytes_Default,
+        int64_t maxIdleMs = kMaxIdleMs_Default);
+    ~FrameBufferPool();
+
+    // Returns a free buffer of the size, or a new one. Never returns null, when a size already has the maximum number
+    // of buffers in use, or the pool is full of buffers in use, the buffer is allocated outside of the pool. Recycled
+    // buffers are not cleared.
+    rtc::scoped_refptr<I420Buffer> CreateI420Buffer(int width, int height);
+    rtc::scoped_refptr<NV12Buffer> CreateNV12Buffer(int width, int height);
+
+    Stats GetStats() const;
+
+    // Drop the free buffers, the buffers in use are freed with their last reference. Called when a video source is
+    // destroyed, as the idle buffers are only aged out by the next request.
+    void Release();
+
+private:
+    using Key = std::tuple<VideoFrameBuffer::Type, int, int>;
+
+    struct Entry {
+        std::list<rtc::scoped_refptr<VideoFrameBuffer>> buffers;
+        uint64_t lastUse{0};
+        int64_t lastUseMs{0};
+        size_t bufferBytes{0};
+    };
+
+    // Returns a free buffer of the key, or null with `pooled` set to whether a new buffer can join the pool.
+    rtc::scoped_refptr<VideoFrameBuffer> GetExistingBuffer(const Key& key, bool* pooled);
+    void AddBuffer(const Key& key, rtc::scoped_refptr<VideoFrameBuffer> buffer);
+    // The methods below are called with the mutex held.
+    // Drop the least recently used sizes beyond the maximum.
+    void Trim();
+    // Drop the free buffers of the sizes not requested for maxIdleMs_.
+    void ReleaseIdle(int64_t nowMs);
+    // Drop the free buffers of the least recently used sizes until the bytes fit, returns false if they can't.
+    bool ReserveBytes(size_t bytes);
+    void ReleaseFreeBuffers(Entry& entry);
+
+    const size_t maxBuffersPerSize_;
+    const size_t maxSizes_;
+    const size_t maxBytes_;
+    const int64_t maxIdleMs_;
+
+    mutable std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+    uint64_t useCount_{0};
+    size_t bufferCount_{0};
+    size_t byteCount_{0};
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> highWater_{0};
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_VIDEO_FRAME_BUFFER_POOL_H
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_buffer_frame_buffer.h"
+#include "frame_buffer_pool.h"
+#include "../utils/marcos.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "api/make_ref_counted.h"
+#include "rtc_base/logging.h"
+#include "libyuv.h"
+
+namespace webrtc {
+
+namespace {
+
+// NV12 view of mapped memory, which keeps the frame buffer owning the memory alive.
+class MappedNV12Buffer : public NV12BufferInterface {
+public:
+    MappedNV12Buffer(
+        rtc::scoped_refptr<VideoFrameBuffer> owner, const uint8_t* dataY, int strideY, const uint8_t* dataUV,
+        int strideUV, int width, int height)
+        : owner_(owner), dataY_(dataY), dataUV_(dataUV), strideY_(strideY), strideUV_(strideUV), width_(width),
+          height_(height)
+    {
+    }
+
+    int width() const override
+    {
+        return width_;
+    }
+
+    int height() const override
+    {
+        return height_;
+    }
+
+    const uint8_t* DataY() const override
+    {
+        return dataY_;
+    }
+
+    const uint8_t* DataUV() const override
+    {
+        return dataUV_;
+    }
+
+    int StrideY() const override
+    {
+        return strideY_;
+    }
+
+    int StrideUV() const override
+    {
+        return strideUV_;
+    }
+
+    rtc::scoped_refptr<I420BufferInterface> ToI420() override
+    {
+        auto i420Buffer = FrameBufferPool::GetDefault().CreateI420Buffer(width_, height_);
+        libyuv::NV12ToI420(
+            dataY_, strideY_, dataUV_, strideUV_, i420Buffer->MutableDataY(), i420Buffer->StrideY(),
+            i420Buffer->MutableDataU(), i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(),
+            width_, height_);
+        return i420Buffer;
+    }
+
+private:
+    const rtc::scoped_refptr<VideoFrameBuffer> owner_;
+    const uint8_t* dataY_;
+    const uint8_t* dataUV_;
+    const int strideY_;
+    const int strideUV_;
+    const int width_;
+    const int height_;
+};
+
+} // namespace
+
+class NativeBufferFrameBuffer::Image : public rtc::RefCountInterface {
+public:
+    Image(
+        OH_ImageNative* image, OH_NativeBuffer* buffer, std::shared_ptr<OH_ImageReceiverNative> receiver,
+        std::shared_ptr<std::atomic<int32_t>> heldImageCount)
+        : image_(image), buffer_(buffer), receiver_(std::move(receiver)), heldImageCount_(std::move(heldImageCount))
+    {
+        OH_NativeBuffer_GetConfig(buffer_, &config_);
+        heldImageCount_->fetch_add(1);
+    }
+
+    ~Image() override
+    {
+        if (addr_) {
+            OH_NativeBuffer_Unmap(buffer_);
+        }
+
+        // hand the buffer back to the receiver, which is released after this if the image was its last one
+        Image_ErrorCode ret = OH_ImageNative_Release(image_);
+        if (ret != IMAGE_SUCCESS) {
+            RTC_LOG(LS_ERROR) << "Failed to release image: " << ret;
+        }
+        heldImageCount_->fetch_sub(1);
+        receiver_.reset();
+    }
+
+    // Map on the first call, the memory stays mapped until the image is released.
+    uint8_t* Map()
+    {
+        UNUSED std::lock_guard<std::mutex> lock(mutex_);
+        if (!addr_) {
+            void* addr = nullptr;
+            int32_t ret = OH_NativeBuffer_Map(buffer_, &addr);
+            if (ret != 0) {
+                RTC_LOG(LS_ERROR) << "Failed to map native buffer: " << ret;
+                return nullptr;
+            }
+            addr_ = static_cast<uint8_t*>(addr);
+        }
+        return addr_;
+    }
+
+    OH_NativeBuffer* GetNativeBuffer() const
+    {
+        return buffer_;
+    }
+
+    const OH_NativeBuffer_Config& GetConfig() const
+    {
+        return config_;
+    }
+
+    // in bytes, as the receiver has always read them
+    int GetStride() const
+    {
+        return config_.format == NATIVEBUFFER_PIXEL_FMT_RGBA_8888 ? config_.stride : config_.width;
+    }
+
+private:
+    OH_ImageNative* const image_;
+    OH_NativeBuffer* const buffer_;
+    std::shared_ptr<OH_ImageReceiverNative> receiver_;
+    const std::shared_ptr<std::atomic<int32_t>> heldImageCount_;
+    OH_NativeBuffer_Config config_{};
+
+    std::mutex mutex_;
+    uint8_t* addr_{nullptr};
+};
+
+bool NativeBufferFrameBuffer::IsFormatSupported(int32_t format)
+{
+    return format == NATIVEBUFFER_PIXEL_FMT_RGBA_8888 || format == NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP;
+}
+
+rtc::scoped_refptr<NativeBufferFrameBuffer> NativeBufferFrameBuffer::Create(
+    OH_ImageNative* image, OH_NativeBuffer* buffer, std::shared_ptr<OH_ImageReceiverNative> receiver,
+    std::shared_ptr<std::atomic<int32_t>> heldImageCount)
+{
+    auto nativeImage = rtc::make_ref_counted<Image>(image, buffer, std::move(receiver), std::move(heldImageCount));
+    const auto& config = nativeImage->GetConfig();
+    return rtc::make_ref_counted<NativeBufferFrameBuffer>(
+        nativeImage, 0, 0, config.width, config.height, config.width, config.height);
+}
+
+NativeBufferFrameBuffer::NativeBufferFrameBuffer(
+    rtc::scoped_refptr<Image> image, int cropX, int cropY, int cropWidth, int cropHeight, int width, int height)
+    : image_(std::move(image)), cropX_(cropX), cropY_(cropY), cropWidth_(cropWidth), cropHeight_(cropHeight),
+      width_(width), height_(height)
+{
+}
+
+NativeBufferFrameBuffer::~NativeBufferFrameBuffer() = default;
+
+rtc::scoped_refptr<I420BufferInterface> NativeBufferFrameBuffer::ToI420()
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    uint8_t* addr = image_->Map();
+    if (!addr) {
+        return nullptr;
+    }
+
+    const auto& config = image_->GetConfig();
+    const int stride = image_->GetStride();
+
+    auto i420Buffer = FrameBufferPool::GetDefault().CreateI420Buffer(cropWidth_, cropHeight_);
+    switch (config.format) {
+        case NATIVEBUFFER_PIXEL_FMT_RGBA_8888: {
+            int32_t ret = libyuv::ABGRToI420(
+                addr + cropY_ * stride + cropX_ * 4, stride, i420Buffer->MutableDataY(), i420Buffer->StrideY(),
+                i420Buffer->MutableDataU(), i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(),
+                cropWidth_, cropHeight_);
+            RTC_DLOG(LS_VERBOSE) << "ABGRToI420 ret = " << ret;
+        } break;
+        case NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP: {
+            const uint8_t* dataUV = addr + stride * config.height;
+            int32_t ret = libyuv::NV12ToI420(
+                addr + cropY_ * stride + cropX_, stride, dataUV + cropY_ / 2 * stride + cropX_, stride,
+                i420Buffer->MutableDataY(), i420Buffer->StrideY(), i420Buffer->MutableDataU(), i420Buffer->StrideU(),
+                i420Buffer->MutableDataV(), i420Buffer->StrideV(), cropWidth_, cropHeight_);
+            RTC_DLOG(LS_VERBOSE) << "NV12ToI420 ret = " << ret;
+        } break;
+        default: {
+            RTC_LOG(LS_ERROR) << "Unsupported pixel format: " << config.format;
+        }
+            return nullptr;
+    }
+
+    if (!IsScaled()) {
+        return i420Buffer;
+    }
+
+    auto scaledBuffer = FrameBufferPool::GetDefault().CreateI420Buffer(width_, height_);
+    scaledBuffer->ScaleFrom(*i420Buffer);
+    return scaledBuffer;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> NativeBufferFrameBuffer::GetMappedFrameBuffer(rtc::ArrayView<Type> types)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    const auto& config = image_->GetConfig();
+    if (config.format == NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP &&
+        std::find(types.begin(), types.end(), Type::kNV12) != types.end())
+    {
+        uint8_t* addr = image_->Map();
+        if (!addr) {
+            return nullptr;
+        }
+
+        const int stride = image_->GetStride();
+        const uint8_t* dataUV = addr + stride * config.height;
+        auto mappedBuffer = rtc::make_ref_counted<MappedNV12Buffer>(
+            rtc::scoped_refptr<VideoFrameBuffer>(this), addr + cropY_ * stride + cropX_, stride,
+            dataUV + cropY_ / 2 * stride + cropX_, stride, cropWidth_, cropHeight_);
+        if (!IsScaled()) {
+            return mappedBuffer;
+        }
+
+        auto scaledBuffer = FrameBufferPool::GetDefault().CreateNV12Buffer(width_, height_);
+        scaledBuffer->CropAndScaleFrom(*mappedBuffer, 0, 0, cropWidth_, cropHeight_);
+        return scaledBuffer;
+    }
+
+    if (std::find(types.begin(), types.end(), Type::kI420) != types.end()) {
+        return ToI420();
+    }
+
+    return nullptr;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> NativeBufferFrameBuffer::CropAndScale(
+    int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
+{
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    // map the region from the scaled size back to the native buffer, with even offsets for the chroma
+    int cropX = cropX_ + offset_x * cropWidth_ / width_;
+    int cropY = cropY_ + offset_y * cropHeight_ / height_;
+    cropX &= ~1;
+    cropY &= ~1;
+    int cropWidth = std::min(crop_width * cropWidth_ / width_, cropX_ + cropWidth_ - cropX);
+    int cropHeight = std::min(crop_height * cropHeight_ / height_, cropY_ + cropHeight_ - cropY);
+
+    return rtc::make_ref_counted<NativeBufferFrameBuffer>(
+        image_, cropX, cropY, cropWidth, cropHeight, scaled_width, scaled_height);
+}
+
+OH_NativeBuffer* NativeBufferFrameBuffer::GetNativeBuffer() const
+{
+    return image_->GetNativeBuffer();
+}
+
+} // namespace webrtc
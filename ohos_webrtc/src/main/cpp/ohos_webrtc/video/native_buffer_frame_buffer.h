@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_VIDEO_NATIVE_BUFFER_FRAME_BUFFER_H
+#define WEBRTC_VIDEO_NATIVE_BUFFER_FRAME_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <multimedia/image_framework/image/image_native.h>
+#include <multimedia/image_framework/image/image_receiver_native.h>
+#include <native_buffer/native_buffer.h>
+
+#include "api/scoped_refptr.h"
+#include "api/video/video_frame_buffer.h"
+
+namespace webrtc {
+
+// Frame buffer backed by the native buffer of a received image, without copying it. The image is held until the last
+// reference to the frame buffer, or to a crop of it, is dropped, and it keeps the image receiver alive until then. The
+// native buffer is mapped the first time the pixels are read, by ToI420() or GetMappedFrameBuffer().
+class NativeBufferFrameBuffer : public VideoFrameBuffer {
+public:
+    static bool IsFormatSupported(int32_t format);
+
+    // Takes the ownership of the image, and shares the one of the receiver it was read from, which is released after
+    // the image. The count of held images is incremented until the image is released.
+    static rtc::scoped_refptr<NativeBufferFrameBuffer> Create(
+        OH_ImageNative* image, OH_NativeBuffer* buffer, std::shared_ptr<OH_ImageReceiverNative> receiver,
+        std::shared_ptr<std::atomic<int32_t>> heldImageCount);
+
+    ~NativeBufferFrameBuffer() override;
+
+    Type type() const override
+    {
+        return Type::kNative;
+    }
+
+    int width() const override
+    {
+        return width_;
+    }
+
+    int height() const override
+    {
+        return height_;
+    }
+
+    rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+
+    // Returns NV12 of the native memory when it is not scaled, or I420.
+    rtc::scoped_refptr<VideoFrameBuffer> GetMappedFrameBuffer(rtc::ArrayView<Type> types) override;
+
+    // Only records the crop and the scale, which are applied when the pixels are read.
+    rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
+        int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height) override;
+
+    OH_NativeBuffer* GetNativeBuffer() const;
+
+protected:
+    class Image;
+
+    NativeBufferFrameBuffer(
+        rtc::scoped_refptr<Image> image, int cropX, int cropY, int cropWidth, int cropHeight, int width, int height);
+
+private:
+    bool IsScaled() const
+    {
+        return cropWidth_ != width_ || cropHeight_ != height_;
+    }
+
+    const rtc::scoped_refptr<Image> image_;
+    // the visible region of the native buffer
+    const int cropX_;
+    const int cropY_;
+    const int cropWidth_;
+    const int cropHeight_;
+    // the size the region is scaled to
+    const int width_;
+    const int height_;
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_VIDEO_NATIVE_BUFFER_FRAME_BUFFER_H
@@ -19,16 +19,29 @@
 #include "api/make_ref_counted.h"
 #include "rtc_base/logging.h"
 
+#include <cmath>
+
 namespace webrtc {
 
 rtc::scoped_refptr<TextureBuffer>
 TextureBuffer::Create(std::weak_ptr<TextureData> texture, int width, int height, const Matrix& transformMatrix)
 {
-    return rtc::make_ref_counted<TextureBuffer>(texture, width, height, transformMatrix);
+    return rtc::make_ref_counted<TextureBuffer>(texture, width, height, width, height, transformMatrix);
 }
 
-TextureBuffer::TextureBuffer(std::weak_ptr<TextureData> texture, int width, int height, const Matrix& transformMatrix)
-    : texture_(texture), width_(width), height_(height), transformMatrix_(transformMatrix)
+rtc::scoped_refptr<TextureBuffer> TextureBuffer::Create(
+    std::weak_ptr<TextureData> texture, int unscaledWidth, int unscaledHeight, int width, int height,
+    const Matrix& transformMatrix)
+{
+    return rtc::make_ref_counted<TextureBuffer>(
+        texture, unscaledWidth, unscaledHeight, width, height, transformMatrix);
+}
+
+TextureBuffer::TextureBuffer(
+    std::weak_ptr<TextureData> texture, int unscaledWidth, int unscaledHeight, int width, int height,
+    const Matrix& transformMatrix)
+    : texture_(texture), unscaledWidth_(unscaledWidth), unscaledHeight_(unscaledHeight), width_(width),
+      height_(height), transformMatrix_(transformMatrix)
 {
     RTC_DLOG(LS_VERBOSE) << "TextureBuffer ctor";
 }
@@ -56,11 +69,29 @@ rtc::scoped_refptr<I420BufferInterface> TextureBuffer::ToI420()
 rtc::scoped_refptr<VideoFrameBuffer> TextureBuffer::CropAndScale(
     int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
 {
-    RTC_LOG(LS_VERBOSE) << __FUNCTION__;
+    RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
+
+    if (offset_x == 0 && offset_y == 0 && crop_width == width_ && crop_height == height_ && scaled_width == width_ &&
+        scaled_height == height_)
+    {
+        return rtc::scoped_refptr<VideoFrameBuffer>(this);
+    }
+
+    // In webrtc, y = 0 is the top row, while in the texture coordinates it is the bottom row.
+    const int offsetYFromBottom = height_ - (offset_y + crop_height);
+
+    Matrix cropMatrix;
+    cropMatrix.PreTranslate(offset_x / static_cast<float>(width_), offsetYFromBottom / static_cast<float>(height_));
+    cropMatrix.PreScale(crop_width / static_cast<float>(width_), crop_height / static_cast<float>(height_), 0, 0);
+
+    Matrix newMatrix = transformMatrix_;
+    newMatrix.PreConcat(cropMatrix);
 
-    // crop and scale by transformMatrix_
-    // for now, just return self without crop and scale.
-    return rtc::scoped_refptr<VideoFrameBuffer>(this);
+    // the texture is only sampled when drawn, at the scaled size
+    return TextureBuffer::Create(
+        texture_, std::lround(unscaledWidth_ * crop_width / static_cast<float>(width_)),
+        std::lround(unscaledHeight_ * crop_height / static_cast<float>(height_)), scaled_width, scaled_height,
+        newMatrix);
 }
 
 } // namespace webrtc
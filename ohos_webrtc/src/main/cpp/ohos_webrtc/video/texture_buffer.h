@@ -82,6 +82,10 @@ class TextureBuffer : public VideoFrameBuffer {
 public:
     static rtc::scoped_refptr<TextureBuffer>
     Create(std::weak_ptr<TextureData> texture, int width, int height, const Matrix& transformMatrix);
+    // The unscaled size is the size of the region of the texture, before it is scaled to width x height.
+    static rtc::scoped_refptr<TextureBuffer> Create(
+        std::weak_ptr<TextureData> texture, int unscaledWidth, int unscaledHeight, int width, int height,
+        const Matrix& transformMatrix);
 
     ~TextureBuffer() override;
 
@@ -102,9 +106,20 @@ public:
 
     rtc::scoped_refptr<I420BufferInterface> ToI420() override;
 
+    // Only composes the crop into the transform matrix, the texture is cropped and scaled when it is drawn.
     rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
         int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height) override;
 
+    int GetUnscaledWidth() const
+    {
+        return unscaledWidth_;
+    }
+
+    int GetUnscaledHeight() const
+    {
+        return unscaledHeight_;
+    }
+
     const Matrix& GetTransformMatrix() const
     {
         return transformMatrix_;
@@ -116,10 +131,14 @@ public:
     }
 
 protected:
-    TextureBuffer(std::weak_ptr<TextureData> texture, int width, int height, const Matrix& transformMatrix);
+    TextureBuffer(
+        std::weak_ptr<TextureData> texture, int unscaledWidth, int unscaledHeight, int width, int height,
+        const Matrix& transformMatrix);
 
 private:
     std::weak_ptr<TextureData> texture_;
+    const int unscaledWidth_;
+    const int unscaledHeight_;
     const int width_;
     const int height_;
     const Matrix transformMatrix_;
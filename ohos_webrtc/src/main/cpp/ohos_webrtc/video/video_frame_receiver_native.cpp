@@ -14,8 +14,11 @@
  */
 
 #include "video_frame_receiver_native.h"
+#include "frame_buffer_pool.h"
+#include "native_buffer_frame_buffer.h"
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/logging.h"
 #include "libyuv.h"
@@ -23,6 +26,8 @@
 namespace webrtc {
 
 constexpr int32_t kBufferCount_Default = 8;
+// images the sinks may hold before the frames are copied, so that the camera always has images to write
+constexpr int32_t kMaxHeldImageCount = kBufferCount_Default - 2;
 
 std::map<OH_ImageReceiverNative*, VideoFrameReceiverNative*> VideoFrameReceiverNative::receiverMap_;
 
@@ -33,7 +38,8 @@ std::unique_ptr<VideoFrameReceiverNative> VideoFrameReceiverNative::Create(const
     return std::make_unique<VideoFrameReceiverNative>(threadName);
 }
 
-VideoFrameReceiverNative::VideoFrameReceiverNative(const std::string& threadName) : thread_(rtc::Thread::Create())
+VideoFrameReceiverNative::VideoFrameReceiverNative(const std::string& threadName)
+    : thread_(rtc::Thread::Create())
 {
     thread_->SetName(threadName, this);
     thread_->Start();
@@ -43,7 +49,8 @@ VideoFrameReceiverNative::~VideoFrameReceiverNative()
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
-    ReleaseImageReceiver();
+    // on the thread reading the images, so that no image is read from the receiver being released
+    thread_->BlockingCall([this] { ReleaseImageReceiver(); });
     thread_->Stop();
 }
 
@@ -52,7 +59,7 @@ uint64_t VideoFrameReceiverNative::GetSurfaceId() const
     uint64_t surfaceId = 0;
 
     if (imageReceiver_) {
-        Image_ErrorCode ret = OH_ImageReceiverNative_GetReceivingSurfaceId(imageReceiver_, &surfaceId);
+        Image_ErrorCode ret = OH_ImageReceiverNative_GetReceivingSurfaceId(imageReceiver_.get(), &surfaceId);
         if (ret != IMAGE_SUCCESS) {
             RTC_LOG(LS_ERROR) << "Failed to get surface id of image receiver";
         }
@@ -78,8 +85,10 @@ void VideoFrameReceiverNative::SetVideoFrameSize(int32_t width, int32_t height)
     width_ = width;
     height_ = height;
 
-    ReleaseImageReceiver();
-    CreateImageReceiver();
+    thread_->BlockingCall([this] {
+        ReleaseImageReceiver();
+        CreateImageReceiver();
+    });
 }
 
 void VideoFrameReceiverNative::CreateImageReceiver()
@@ -116,8 +125,15 @@ void VideoFrameReceiverNative::CreateImageReceiver()
         }
 
         receiverMap_[imageReceiver] = this;
-        imageReceiver_ = imageReceiver;
-        ret = OH_ImageReceiverNative_On(imageReceiver_, VideoFrameReceiverNative::OnImageReceiverCallback1);
+        imageReceiver_ = std::shared_ptr<OH_ImageReceiverNative>(imageReceiver, [](OH_ImageReceiverNative* receiver) {
+            Image_ErrorCode ret = OH_ImageReceiverNative_Release(receiver);
+            if (ret != IMAGE_SUCCESS) {
+                RTC_LOG(LS_ERROR) << "Failed to release image receiver";
+            }
+        });
+        heldImageCount_ = std::make_shared<std::atomic<int32_t>>(0);
+        copying_ = false;
+        ret = OH_ImageReceiverNative_On(imageReceiver_.get(), VideoFrameReceiverNative::OnImageReceiverCallback1);
         if (ret != IMAGE_SUCCESS) {
             RTC_LOG(LS_ERROR) << "Failed to set callback of image receiver";
         }
@@ -136,18 +152,15 @@ void VideoFrameReceiverNative::ReleaseImageReceiver()
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
     if (imageReceiver_) {
-        Image_ErrorCode ret = OH_ImageReceiverNative_Off(imageReceiver_);
+        Image_ErrorCode ret = OH_ImageReceiverNative_Off(imageReceiver_.get());
         if (ret != IMAGE_SUCCESS) {
             RTC_LOG(LS_ERROR) << "Failed to unset callback of image receiver";
         }
 
-        ret = OH_ImageReceiverNative_Release(imageReceiver_);
-        if (ret != IMAGE_SUCCESS) {
-            RTC_LOG(LS_ERROR) << "Failed to release image receiver";
-        }
-
-        receiverMap_.erase(imageReceiver_);
-        imageReceiver_ = nullptr;
+        receiverMap_.erase(imageReceiver_.get());
+        // released now, or with the last image still held by the sinks, e.g. the last frame of a renderer
+        imageReceiver_.reset();
+        heldImageCount_.reset();
     }
 }
 
@@ -172,8 +185,12 @@ void VideoFrameReceiverNative::OnImageReceiverCallback()
         return;
     }
 
+    if (!imageReceiver_) {
+        return;
+    }
+
     OH_ImageNative* image;
-    Image_ErrorCode ret = OH_ImageReceiverNative_ReadNextImage(imageReceiver_, &image);
+    Image_ErrorCode ret = OH_ImageReceiverNative_ReadNextImage(imageReceiver_.get(), &image);
     if (ret != IMAGE_SUCCESS) {
         RTC_LOG(LS_ERROR) << "Failed to read latest image: " << ret;
         return;
@@ -257,38 +274,63 @@ void VideoFrameReceiverNative::OnImageReceiverCallback()
     OH_NativeBuffer_GetConfig(buffer, &bufferConfig);
     RTC_DLOG(LS_VERBOSE) << "Buffer config: format=" << bufferConfig.format << " usage=" << bufferConfig.usage;
 
+    const int32_t heldImageCount = heldImageCount_->load();
+    if (heldImageCount >= kMaxHeldImageCount) {
+        if (!copying_) {
+            RTC_LOG(LS_WARNING) << "Sinks hold " << heldImageCount << " images, copy the frames";
+            copying_ = true;
+        }
+    } else if (copying_) {
+        RTC_LOG(LS_INFO) << "Sinks released the images, stop copying the frames";
+        copying_ = false;
+    }
+
+    if (!copying_ && NativeBufferFrameBuffer::IsFormatSupported(bufferConfig.format)) {
+        // the frame buffer owns the image from now on
+        auto frameBuffer = NativeBufferFrameBuffer::Create(image, buffer, imageReceiver_, heldImageCount_);
+        if (callback_) {
+            callback_->OnFrameAvailable(frameBuffer, rtc::TimeMicros(), kVideoRotation_0);
+        }
+        return;
+    }
+
     void* addr = nullptr;
     OH_NativeBuffer_Map(buffer, &addr);
     RTC_DLOG(LS_VERBOSE) << "Buffer map addr: " << addr;
 
-    rtc::scoped_refptr<I420Buffer> i420Buffer = I420Buffer::Create(bufferConfig.width, bufferConfig.height);
-
+    // the semi-planar formats stay NV12, which the hardware encoder takes as is, only rgba is converted to I420
+    rtc::scoped_refptr<VideoFrameBuffer> frameBuffer;
     switch (bufferConfig.format) {
         case NATIVEBUFFER_PIXEL_FMT_RGBA_8888: {
+            auto i420Buffer = FrameBufferPool::GetDefault().CreateI420Buffer(bufferConfig.width, bufferConfig.height);
             libyuv::ABGRToI420(
                 (uint8_t*)addr, bufferConfig.stride, i420Buffer->MutableDataY(), i420Buffer->StrideY(),
                 i420Buffer->MutableDataU(), i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(),
                 bufferConfig.width, bufferConfig.height);
             RTC_DLOG(LS_VERBOSE) << "ABGRToI420 ret = " << ret;
+            frameBuffer = i420Buffer;
         } break;
         case NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP: {
-            int32_t ret = libyuv::NV12ToI420(
+            auto nv12Buffer = FrameBufferPool::GetDefault().CreateNV12Buffer(bufferConfig.width, bufferConfig.height);
+            int32_t ret = libyuv::NV12Copy(
                 (uint8_t*)addr, bufferConfig.width, (uint8_t*)addr + bufferConfig.width * bufferConfig.height,
-                bufferConfig.width, i420Buffer->MutableDataY(), i420Buffer->StrideY(), i420Buffer->MutableDataU(),
-                i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(), bufferConfig.width,
-                bufferConfig.height);
-            RTC_DLOG(LS_VERBOSE) << "NV12ToI420 ret = " << ret;
+                bufferConfig.width, nv12Buffer->MutableDataY(), nv12Buffer->StrideY(), nv12Buffer->MutableDataUV(),
+                nv12Buffer->StrideUV(), bufferConfig.width, bufferConfig.height);
+            RTC_DLOG(LS_VERBOSE) << "NV12Copy ret = " << ret;
+            frameBuffer = nv12Buffer;
         } break;
         case NATIVEBUFFER_PIXEL_FMT_YCRCB_420_SP: {
-            int32_t ret = libyuv::NV21ToI420(
+            auto nv12Buffer = FrameBufferPool::GetDefault().CreateNV12Buffer(bufferConfig.width, bufferConfig.height);
+            int32_t ret = libyuv::NV21ToNV12(
                 (uint8_t*)addr, bufferConfig.width, (uint8_t*)addr + bufferConfig.width * bufferConfig.height,
-                bufferConfig.width, i420Buffer->MutableDataY(), i420Buffer->StrideY(), i420Buffer->MutableDataU(),
-                i420Buffer->StrideU(), i420Buffer->MutableDataV(), i420Buffer->StrideV(), bufferConfig.width,
-                bufferConfig.height);
-            RTC_DLOG(LS_VERBOSE) << "NV21ToI420 ret = " << ret;
+                bufferConfig.width, nv12Buffer->MutableDataY(), nv12Buffer->StrideY(), nv12Buffer->MutableDataUV(),
+                nv12Buffer->StrideUV(), bufferConfig.width, bufferConfig.height);
+            RTC_DLOG(LS_VERBOSE) << "NV21ToNV12 ret = " << ret;
+            frameBuffer = nv12Buffer;
         } break;
         default: {
             RTC_LOG(LS_ERROR) << "Unsupported pixel format: " << bufferConfig.format;
+            OH_NativeBuffer_Unmap(buffer);
             ret = OH_ImageNative_Release(image);
             if (ret != IMAGE_SUCCESS) {
                 RTC_LOG(LS_ERROR) << "Failed to release image: " << ret;
@@ -298,9 +340,10 @@ void VideoFrameReceiverNative::OnImageReceiverCallback()
     }
 
     if (callback_) {
-        callback_->OnFrameAvailable(i420Buffer, rtc::TimeMicros(), kVideoRotation_0);
+        callback_->OnFrameAvailable(frameBuffer, rtc::TimeMicros(), kVideoRotation_0);
     }
 
+    OH_NativeBuffer_Unmap(buffer);
     ret = OH_ImageNative_Release(image);
     if (ret != IMAGE_SUCCESS) {
         RTC_LOG(LS_ERROR) << "Failed to release image: " << ret;
@@ -18,6 +18,7 @@
 
 #include "video_frame_receiver.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <cstdint>
@@ -52,7 +53,13 @@ private:
     std::unique_ptr<rtc::Thread> thread_;
     int32_t width_{};
     int32_t height_{};
-    OH_ImageReceiverNative* imageReceiver_{nullptr};
+    // shared with the zero copy frame buffers, the receiver is released with the last image held by the sinks
+    std::shared_ptr<OH_ImageReceiverNative> imageReceiver_;
+
+    // images of the receiver held by the sinks through zero copy frame buffers, released on any thread
+    std::shared_ptr<std::atomic<int32_t>> heldImageCount_;
+    // whether the frames are copied because the sinks hold too many images
+    bool copying_{false};
 };
 
 } // namespace webrtc
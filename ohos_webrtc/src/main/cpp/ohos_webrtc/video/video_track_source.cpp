@@ -16,8 +16,10 @@
 #include "video_track_source.h"
 #include "utils/marcos.h"
 #include "video_frame_receiver_gl.h"
+#include "frame_buffer_pool.h"
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
@@ -69,6 +71,9 @@ OhosVideoTrackSource::~OhosVideoTrackSource()
         capturer_.reset();
     });
     thread_->Stop();
+
+    // the frames of this source are not requested anymore, don't keep their buffers until the next request
+    FrameBufferPool::GetDefault().Release();
 }
 
 void OhosVideoTrackSource::Start()
@@ -286,7 +291,19 @@ void OhosVideoTrackSource::OnFrameCaptured(
     }
 
     if (adapted_height != buffer->height() || adapted_width != buffer->width()) {
-        buffer = buffer->CropAndScale(crop_x, crop_y, crop_width, crop_height, adapted_width, adapted_height);
+        if (buffer->type() == VideoFrameBuffer::Type::kI420) {
+            // scale into a pooled buffer, the default implementation allocates one per frame
+            auto scaled = FrameBufferPool::GetDefault().CreateI420Buffer(adapted_width, adapted_height);
+            scaled->CropAndScaleFrom(*buffer->GetI420(), crop_x, crop_y, crop_width, crop_height);
+            buffer = scaled;
+        } else if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+            // keep NV12 for the hardware encoder instead of the I420 of the default implementation
+            auto scaled = FrameBufferPool::GetDefault().CreateNV12Buffer(adapted_width, adapted_height);
+            scaled->CropAndScaleFrom(*buffer->GetNV12(), crop_x, crop_y, crop_width, crop_height);
+            buffer = scaled;
+        } else {
+            buffer = buffer->CropAndScale(crop_x, crop_y, crop_width, crop_height, adapted_width, adapted_height);
+        }
     } else {
         // No adaptations needed, just return the frame as is.
     }
@@ -297,10 +314,12 @@ void OhosVideoTrackSource::OnFrameCaptured(
                      .set_rotation(rotation)
                      .set_timestamp_us(alignedTimestampUs)
                      .build();
-    if (ApplyRotation() && frame.rotation() != kVideoRotation_0 && buffer->type() == VideoFrameBuffer::Type::kI420) {
+    if (ApplyRotation() && frame.rotation() != kVideoRotation_0 &&
+        (buffer->type() == VideoFrameBuffer::Type::kI420 || buffer->type() == VideoFrameBuffer::Type::kNV12))
+    {
         /* Apply pending rotation. */
         VideoFrame rotatedFrame(frame);
-        rotatedFrame.set_video_frame_buffer(I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()));
+        rotatedFrame.set_video_frame_buffer(I420Buffer::Rotate(*buffer->ToI420(), frame.rotation()));
         rotatedFrame.set_rotation(kVideoRotation_0);
         broadcaster_.OnFrame(rotatedFrame);
     } else {
@@ -15,6 +15,7 @@
 
 #include "hardware_video_decoder.h"
 #include "../video/video_frame_receiver_gl.h"
+#include "../video/frame_buffer_pool.h"
 #include "../utils/marcos.h"
 
 #include <native_buffer/native_buffer.h>
@@ -473,7 +474,7 @@ void HardwareVideoDecoder::DeliverByteFrame(const ohos::CodecBuffer& buffer)
     int width = resolution.Width();
     int height = resolution.Height();
 
-    auto i420Buffer = I420Buffer::Create(width, height);
+    auto i420Buffer = FrameBufferPool::GetDefault().CreateI420Buffer(width, height);
     switch (colorFormat_) {
         case AV_PIXEL_FORMAT_YUVI420: {
             // copy data
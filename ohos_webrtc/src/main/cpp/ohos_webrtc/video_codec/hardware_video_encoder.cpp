@@ -532,7 +532,8 @@ int32_t HardwareVideoEncoder::EncodeByteBuffer(const VideoFrame& frame)
 {
     RTC_DLOG(LS_VERBOSE) << __FUNCTION__;
 
-    if (frame.is_texture()) {
+    auto frameBuffer = frame.video_frame_buffer();
+    if (frame.is_texture() && dynamic_cast<TextureBuffer*>(frameBuffer.get())) {
         RTC_LOG(LS_ERROR) << "Texture buffer is not supported in buffer mode yet";
         return WEBRTC_VIDEO_CODEC_ERROR;
     }
@@ -560,10 +561,33 @@ int32_t HardwareVideoEncoder::EncodeByteBuffer(const VideoFrame& frame)
         return WEBRTC_VIDEO_CODEC_ERROR;
     }
 
-    auto srcBuffer = frame.video_frame_buffer()->ToI420();
     int width = frame.width();
     int height = frame.height();
 
+    if (frameBuffer->type() == VideoFrameBuffer::Type::kNative) {
+        // copy the planes of a native buffer straight from its mapping
+        VideoFrameBuffer::Type nv12Type[] = {VideoFrameBuffer::Type::kNV12};
+        auto mappedBuffer = frameBuffer->GetMappedFrameBuffer(nv12Type);
+        if (mappedBuffer) {
+            frameBuffer = mappedBuffer;
+        }
+    }
+
+    if (frameBuffer->type() == VideoFrameBuffer::Type::kNV12) {
+        if (!CopyNV12Buffer(*frameBuffer->GetNV12(), addr, width, height)) {
+            QueueInputBuffer(codecBuffer);
+            return WEBRTC_VIDEO_CODEC_ERROR;
+        }
+        return PushInputBuffer(frame, codecBuffer, attr);
+    }
+
+    auto srcBuffer = frameBuffer->ToI420();
+    if (!srcBuffer) {
+        RTC_LOG(LS_ERROR) << "Failed to convert frame buffer to I420";
+        QueueInputBuffer(codecBuffer);
+        return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+
     switch (pixelFormat_) {
         case AV_PIXEL_FORMAT_YUVI420: {
             // copy
@@ -596,9 +620,53 @@ int32_t HardwareVideoEncoder::EncodeByteBuffer(const VideoFrame& frame)
             return WEBRTC_VIDEO_CODEC_ERROR;
     }
 
+    return PushInputBuffer(frame, codecBuffer, attr);
+}
+
+bool HardwareVideoEncoder::CopyNV12Buffer(const NV12BufferInterface& srcBuffer, uint8_t* addr, int width, int height)
+{
+    int32_t ret = 0;
+    switch (pixelFormat_) {
+        case AV_PIXEL_FORMAT_NV12: {
+            ret = libyuv::NV12Copy(
+                srcBuffer.DataY(), srcBuffer.StrideY(), srcBuffer.DataUV(), srcBuffer.StrideUV(), addr, width,
+                addr + width * height, width, width, height);
+            RTC_DLOG(LS_VERBOSE) << "NV12Copy ret = " << ret;
+        } break;
+        case AV_PIXEL_FORMAT_NV21: {
+            // swapping the chroma goes both ways
+            ret = libyuv::NV21ToNV12(
+                srcBuffer.DataY(), srcBuffer.StrideY(), srcBuffer.DataUV(), srcBuffer.StrideUV(), addr, width,
+                addr + width * height, width, width, height);
+            RTC_DLOG(LS_VERBOSE) << "NV21ToNV12 ret = " << ret;
+        } break;
+        case AV_PIXEL_FORMAT_YUVI420: {
+            ret = libyuv::NV12ToI420(
+                srcBuffer.DataY(), srcBuffer.StrideY(), srcBuffer.DataUV(), srcBuffer.StrideUV(), addr, width,
+                addr + width * height, width / 2, addr + width * height * 5 / 4, width / 2, width, height);
+            RTC_DLOG(LS_VERBOSE) << "NV12ToI420 ret = " << ret;
+        } break;
+        case AV_PIXEL_FORMAT_RGBA: {
+            ret = libyuv::NV12ToABGR(
+                srcBuffer.DataY(), srcBuffer.StrideY(), srcBuffer.DataUV(), srcBuffer.StrideUV(), addr, width * 4,
+                width, height);
+            RTC_DLOG(LS_VERBOSE) << "NV12ToABGR ret = " << ret;
+        } break;
+        default: {
+            RTC_LOG(LS_ERROR) << "Unsupported pixel format: " << pixelFormat_;
+        }
+            return false;
+    }
+
+    return ret == 0;
+}
+
+int32_t HardwareVideoEncoder::PushInputBuffer(
+    const VideoFrame& frame, ohos::CodecBuffer& codecBuffer, OH_AVCodecBufferAttr& attr)
+{
     attr.pts = frame.timestamp_us();
     attr.size = frame.size();
-    ret = OH_AVBuffer_SetBufferAttr(codecBuffer.buf, &attr);
+    int32_t ret = OH_AVBuffer_SetBufferAttr(codecBuffer.buf, &attr);
     if (ret != AV_ERR_OK) {
         RTC_LOG(LS_ERROR) << "Failed to get buffer attr: " << ret;
         QueueInputBuffer(codecBuffer);
@@ -37,6 +37,7 @@
 #include <multimedia/player_framework/native_avcodec_base.h>
 #include <multimedia/player_framework/native_avformat.h>
 
+#include <api/video/video_frame_buffer.h>
 #include <api/video_codecs/video_encoder.h>
 #include <api/video_codecs/sdp_video_format.h>
 
@@ -83,6 +84,9 @@ private:
 
     int32_t EncodeTextureBuffer(const VideoFrame& frame);
     int32_t EncodeByteBuffer(const VideoFrame& frame);
+    // Copy the planes into the input buffer in the pixel format of the encoder, without an I420 intermediate.
+    bool CopyNV12Buffer(const NV12BufferInterface& srcBuffer, uint8_t* addr, int width, int height);
+    int32_t PushInputBuffer(const VideoFrame& frame, ohos::CodecBuffer& codecBuffer, OH_AVCodecBufferAttr& attr);
 
 private:
     struct FrameExtraInfo {
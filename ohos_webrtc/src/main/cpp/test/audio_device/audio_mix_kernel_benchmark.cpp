@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_device/audio_mix_kernel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int kFrameDurationInMs = 10;
+
+// One 10 ms frame of MixingAudioInput::DoMix with all the inputs at the mix rate: clear the accumulator, mix every
+// input, measure the peak and store with the limiter gain. Args are the number of inputs and the sample rate.
+void BM_MixFrame(benchmark::State& state)
+{
+    const int inputCount = static_cast<int>(state.range(0));
+    const int sampleRate = static_cast<int>(state.range(1));
+    const size_t frames = sampleRate / 1000 * kFrameDurationInMs;
+    const size_t samplesPerFrame = frames * kChannels;
+
+    std::mt19937 random(0);
+    std::uniform_int_distribution<int> distribution(INT16_MIN, INT16_MAX);
+    std::vector<std::vector<int16_t>> inputs(inputCount, std::vector<int16_t>(samplesPerFrame));
+    for (auto& input : inputs) {
+        std::generate(input.begin(), input.end(), [&] { return static_cast<int16_t>(distribution(random)); });
+    }
+
+    std::vector<float> mixData(samplesPerFrame);
+    std::vector<int16_t> frameData(samplesPerFrame);
+    float limiterGain = 1.0f;
+
+    for (auto _ : state) {
+        std::fill(mixData.begin(), mixData.end(), 0.0f);
+        for (const auto& input : inputs) {
+            MixS16(input.data(), frames, kChannels, kChannels, 0.8f, mixData.data());
+        }
+
+        float peak = GetPeakLevel(mixData.data(), samplesPerFrame);
+        float targetGain = peak > 32767.0f ? 32767.0f / peak : 1.0f;
+        limiterGain = std::min({1.0f, targetGain, limiterGain * 1.05f});
+
+        StoreS16(mixData.data(), samplesPerFrame, limiterGain, frameData.data());
+        benchmark::DoNotOptimize(frameData.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["frames"] = static_cast<double>(frames);
+}
+
+BENCHMARK(BM_MixFrame)->ArgNames({"inputs", "rate"})->ArgsProduct({{1, 2, 3, 4}, {16000, 48000}});
+
+} // namespace
+
+} // namespace webrtc
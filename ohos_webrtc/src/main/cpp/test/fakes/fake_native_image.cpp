@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_native_image.h"
+
+namespace webrtc {
+
+FakeNativeImage::FakeNativeImage(int width, int height, int32_t format)
+{
+    config_.width = width;
+    config_.height = height;
+    config_.format = format;
+    if (format == NATIVEBUFFER_PIXEL_FMT_RGBA_8888) {
+        config_.stride = width * 4 + 64;
+        data_.resize(config_.stride * height);
+    } else {
+        config_.stride = width;
+        data_.resize(width * height * 3 / 2);
+    }
+}
+
+FakeNativeImage::~FakeNativeImage() = default;
+
+// the handles are only ever passed back to the functions below
+OH_ImageNative* FakeNativeImage::image()
+{
+    return reinterpret_cast<OH_ImageNative*>(this);
+}
+
+OH_NativeBuffer* FakeNativeImage::buffer()
+{
+    return reinterpret_cast<OH_NativeBuffer*>(this);
+}
+
+FakeNativeImage* FakeNativeImage::From(OH_NativeBuffer* buffer)
+{
+    return reinterpret_cast<FakeNativeImage*>(buffer);
+}
+
+FakeNativeImage* FakeNativeImage::From(OH_ImageNative* image)
+{
+    return reinterpret_cast<FakeNativeImage*>(image);
+}
+
+std::shared_ptr<OH_ImageReceiverNative> CreateFakeImageReceiver(std::function<void()> onRelease)
+{
+    static int handle = 0;
+    return std::shared_ptr<OH_ImageReceiverNative>(
+        reinterpret_cast<OH_ImageReceiverNative*>(&handle),
+        [onRelease = std::move(onRelease)](OH_ImageReceiverNative*) { onRelease(); });
+}
+
+} // namespace webrtc
+
+using webrtc::FakeNativeImage;
+
+void OH_NativeBuffer_GetConfig(OH_NativeBuffer* buffer, OH_NativeBuffer_Config* config)
+{
+    *config = FakeNativeImage::From(buffer)->config_;
+}
+
+int32_t OH_NativeBuffer_Map(OH_NativeBuffer* buffer, void** virAddr)
+{
+    auto* fake = FakeNativeImage::From(buffer);
+    fake->mapCount_++;
+    *virAddr = fake->data_.data();
+    return 0;
+}
+
+int32_t OH_NativeBuffer_Unmap(OH_NativeBuffer* buffer)
+{
+    FakeNativeImage::From(buffer)->unmapCount_++;
+    return 0;
+}
+
+Image_ErrorCode OH_ImageNative_Release(OH_ImageNative* image)
+{
+    FakeNativeImage::From(image)->released_ = true;
+    return IMAGE_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WEBRTC_TEST_FAKES_FAKE_NATIVE_IMAGE_H
+#define WEBRTC_TEST_FAKES_FAKE_NATIVE_IMAGE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <multimedia/image_framework/image/image_native.h>
+#include <multimedia/image_framework/image/image_receiver_native.h>
+#include <native_buffer/native_buffer.h>
+
+namespace webrtc {
+
+// An image of the image receiver, backed by host memory instead of a native buffer. The fakes of native_buffer.h and
+// image_native.h under this directory record the calls made on it.
+class FakeNativeImage {
+public:
+    FakeNativeImage(int width, int height, int32_t format);
+    ~FakeNativeImage();
+
+    OH_ImageNative* image();
+    OH_NativeBuffer* buffer();
+
+    uint8_t* data()
+    {
+        return data_.data();
+    }
+
+    // in bytes, padded for RGBA like the buffers of the camera
+    int stride() const
+    {
+        return config_.stride;
+    }
+
+    int mapCount() const
+    {
+        return mapCount_;
+    }
+
+    int unmapCount() const
+    {
+        return unmapCount_;
+    }
+
+    bool released() const
+    {
+        return released_;
+    }
+
+private:
+    friend void ::OH_NativeBuffer_GetConfig(OH_NativeBuffer*, OH_NativeBuffer_Config*);
+    friend int32_t ::OH_NativeBuffer_Map(OH_NativeBuffer*, void**);
+    friend int32_t ::OH_NativeBuffer_Unmap(OH_NativeBuffer*);
+    friend Image_ErrorCode(::OH_ImageNative_Release)(OH_ImageNative*);
+
+    static FakeNativeImage* From(OH_NativeBuffer* buffer);
+    static FakeNativeImage* From(OH_ImageNative* image);
+
+    OH_NativeBuffer_Config config_{};
+    std::vector<uint8_t> data_;
+    int mapCount_{0};
+    int unmapCount_{0};
+    bool released_{false};
+};
+
+// A receiver handle shared like the one of VideoFrameReceiverNative, calling onRelease instead of releasing it.
+std::shared_ptr<OH_ImageReceiverNative> CreateFakeImageReceiver(std::function<void()> onRelease);
+
+} // namespace webrtc
+
+#endif // WEBRTC_TEST_FAKES_FAKE_NATIVE_IMAGE_H
@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Fake of the OpenHarmony header for the host tests, only what the tested sources use. See fake_native_image.h.
+
+#ifndef WEBRTC_TEST_FAKES_IMAGE_NATIVE_H
+#define WEBRTC_TEST_FAKES_IMAGE_NATIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    IMAGE_SUCCESS = 0,
+    IMAGE_BAD_PARAMETER = 401,
+} Image_ErrorCode;
+
+typedef struct OH_ImageNative OH_ImageNative;
+
+Image_ErrorCode OH_ImageNative_Release(OH_ImageNative* image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEBRTC_TEST_FAKES_IMAGE_NATIVE_H
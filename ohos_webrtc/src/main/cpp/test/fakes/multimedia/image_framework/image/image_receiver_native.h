@@ -0,0 +1,33 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Fake of the OpenHarmony header for the host tests, only what the tested sources use. See fake_native_image.h.
+
+#ifndef WEBRTC_TEST_FAKES_IMAGE_RECEIVER_NATIVE_H
+#define WEBRTC_TEST_FAKES_IMAGE_RECEIVER_NATIVE_H
+
+#include "image_native.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OH_ImageReceiverNative OH_ImageReceiverNative;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEBRTC_TEST_FAKES_IMAGE_RECEIVER_NATIVE_H
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Fake of the OpenHarmony header for the host tests, only what the tested sources use. See fake_native_image.h.
+
+#ifndef WEBRTC_TEST_FAKES_NATIVE_BUFFER_H
+#define WEBRTC_TEST_FAKES_NATIVE_BUFFER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OH_NativeBuffer OH_NativeBuffer;
+
+enum OH_NativeBuffer_Format {
+    NATIVEBUFFER_PIXEL_FMT_RGBA_8888 = 12,
+    NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP = 24,
+    NATIVEBUFFER_PIXEL_FMT_YCRCB_420_SP = 25,
+};
+
+typedef struct {
+    int32_t width;
+    int32_t height;
+    int32_t format;
+    int32_t usage;
+    int32_t stride;
+} OH_NativeBuffer_Config;
+
+void OH_NativeBuffer_GetConfig(OH_NativeBuffer* buffer, OH_NativeBuffer_Config* config);
+int32_t OH_NativeBuffer_Map(OH_NativeBuffer* buffer, void** virAddr);
+int32_t OH_NativeBuffer_Unmap(OH_NativeBuffer* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEBRTC_TEST_FAKES_NATIVE_BUFFER_H
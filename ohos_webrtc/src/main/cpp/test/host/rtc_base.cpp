@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host replacements of the rtc_base functions the tested sources link against. deps/webrtc only ships headers, so
+// these follow the upstream implementations closely enough for the unit tests.
+
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/memory/aligned_malloc.h"
+#include "rtc_base/time_utils.h"
+
+namespace rtc {
+namespace webrtc_checks_impl {
+
+#if RTC_CHECK_MSG_ENABLED
+RTC_NORETURN void FatalLog(const char* file, int line, const char* message, const CheckArgType* fmt, ...)
+{
+    // the arguments of the failed comparison are not decoded, the message is enough to find the check
+    fprintf(stderr, "\n\n#\n# Fatal error in: %s, line %d\n# last system error: %d\n# Check failed: %s\n#\n", file,
+        line, errno, message);
+    fflush(stderr);
+    abort();
+}
+#else
+RTC_NORETURN void FatalLog(const char* file, int line)
+{
+    fprintf(stderr, "\n\n#\n# Fatal error in: %s, line %d\n# last system error: %d\n# Check failed.\n#\n", file, line,
+        errno);
+    fflush(stderr);
+    abort();
+}
+#endif
+
+} // namespace webrtc_checks_impl
+
+// without the fake clock of webrtc
+int64_t TimeMillis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace rtc
+
+namespace webrtc {
+
+void* AlignedMalloc(size_t size, size_t alignment)
+{
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignment, size) != 0) {
+        return nullptr;
+    }
+    return memory;
+}
+
+void AlignedFree(void* mem_block)
+{
+    free(mem_block);
+}
+
+} // namespace webrtc
@@ -0,0 +1,451 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host replacements of the webrtc video frame buffers used by the tested sources, following the upstream
+// implementations in api/video/ and built on the system libyuv.
+
+#include <algorithm>
+#include <cstring>
+
+#include "api/make_ref_counted.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
+#include "api/video/video_frame_buffer.h"
+#include "libyuv/convert.h"
+#include "libyuv/convert_from.h"
+#include "libyuv/planar_functions.h"
+#include "libyuv/rotate.h"
+#include "libyuv/scale.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kBufferAlignment = 64;
+
+int I420DataSize(int height, int strideY, int strideU, int strideV)
+{
+    return strideY * height + (strideU + strideV) * ((height + 1) / 2);
+}
+
+int NV12DataSize(int height, int strideY, int strideUV)
+{
+    return strideY * height + strideUV * ((height + 1) / 2);
+}
+
+} // namespace
+
+// VideoFrameBuffer
+
+const I420BufferInterface* VideoFrameBuffer::GetI420() const
+{
+    return nullptr;
+}
+
+const NV12BufferInterface* VideoFrameBuffer::GetNV12() const
+{
+    RTC_CHECK(type() == Type::kNV12);
+    return static_cast<const NV12BufferInterface*>(this);
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::CropAndScale(
+    int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
+{
+    rtc::scoped_refptr<I420Buffer> result = I420Buffer::Create(scaled_width, scaled_height);
+    result->CropAndScaleFrom(*this->ToI420(), offset_x, offset_y, crop_width, crop_height);
+    return result;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::GetMappedFrameBuffer(rtc::ArrayView<Type> types)
+{
+    RTC_CHECK(type() == Type::kNative);
+    return nullptr;
+}
+
+const char* VideoFrameBufferTypeToString(VideoFrameBuffer::Type type)
+{
+    switch (type) {
+        case VideoFrameBuffer::Type::kNative:
+            return "kNative";
+        case VideoFrameBuffer::Type::kI420:
+            return "kI420";
+        case VideoFrameBuffer::Type::kI420A:
+            return "kI420A";
+        case VideoFrameBuffer::Type::kI422:
+            return "kI422";
+        case VideoFrameBuffer::Type::kI444:
+            return "kI444";
+        case VideoFrameBuffer::Type::kI010:
+            return "kI010";
+        case VideoFrameBuffer::Type::kI210:
+            return "kI210";
+        case VideoFrameBuffer::Type::kI410:
+            return "kI410";
+        case VideoFrameBuffer::Type::kNV12:
+            return "kNV12";
+        default:
+            RTC_DCHECK_NOTREACHED();
+    }
+    return nullptr;
+}
+
+// I420BufferInterface
+
+VideoFrameBuffer::Type I420BufferInterface::type() const
+{
+    return Type::kI420;
+}
+
+int I420BufferInterface::ChromaWidth() const
+{
+    return (width() + 1) / 2;
+}
+
+int I420BufferInterface::ChromaHeight() const
+{
+    return (height() + 1) / 2;
+}
+
+rtc::scoped_refptr<I420BufferInterface> I420BufferInterface::ToI420()
+{
+    return rtc::scoped_refptr<I420BufferInterface>(this);
+}
+
+const I420BufferInterface* I420BufferInterface::GetI420() const
+{
+    return this;
+}
+
+// NV12BufferInterface
+
+VideoFrameBuffer::Type NV12BufferInterface::type() const
+{
+    return Type::kNV12;
+}
+
+int NV12BufferInterface::ChromaWidth() const
+{
+    return (width() + 1) / 2;
+}
+
+int NV12BufferInterface::ChromaHeight() const
+{
+    return (height() + 1) / 2;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> NV12BufferInterface::CropAndScale(
+    int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
+{
+    rtc::scoped_refptr<NV12Buffer> result = NV12Buffer::Create(scaled_width, scaled_height);
+    result->CropAndScaleFrom(*this, offset_x, offset_y, crop_width, crop_height);
+    return result;
+}
+
+// I420Buffer
+
+I420Buffer::I420Buffer(int width, int height) : I420Buffer(width, height, width, (width + 1) / 2, (width + 1) / 2) {}
+
+I420Buffer::I420Buffer(int width, int height, int stride_y, int stride_u, int stride_v)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_u_(stride_u),
+      stride_v_(stride_v),
+      data_(static_cast<uint8_t*>(
+          AlignedMalloc(I420DataSize(height, stride_y, stride_u, stride_v), kBufferAlignment)))
+{
+    RTC_DCHECK_GT(width, 0);
+    RTC_DCHECK_GT(height, 0);
+    RTC_DCHECK_GE(stride_y, width);
+    RTC_DCHECK_GE(stride_u, (width + 1) / 2);
+    RTC_DCHECK_GE(stride_v, (width + 1) / 2);
+}
+
+I420Buffer::~I420Buffer() {}
+
+rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width, int height)
+{
+    return rtc::make_ref_counted<I420Buffer>(width, height);
+}
+
+rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width, int height, int stride_y, int stride_u, int stride_v)
+{
+    return rtc::make_ref_counted<I420Buffer>(width, height, stride_y, stride_u, stride_v);
+}
+
+rtc::scoped_refptr<I420Buffer> I420Buffer::Copy(const I420BufferInterface& source)
+{
+    return Copy(source.width(), source.height(), source.DataY(), source.StrideY(), source.DataU(), source.StrideU(),
+        source.DataV(), source.StrideV());
+}
+
+rtc::scoped_refptr<I420Buffer> I420Buffer::Copy(int width, int height, const uint8_t* data_y, int stride_y,
+    const uint8_t* data_u, int stride_u, const uint8_t* data_v, int stride_v)
+{
+    rtc::scoped_refptr<I420Buffer> buffer = Create(width, height);
+    RTC_CHECK_EQ(0, libyuv::I420Copy(data_y, stride_y, data_u, stride_u, data_v, stride_v, buffer->MutableDataY(),
+                        buffer->StrideY(), buffer->MutableDataU(), buffer->StrideU(), buffer->MutableDataV(),
+                        buffer->StrideV(), width, height));
+    return buffer;
+}
+
+rtc::scoped_refptr<I420Buffer> I420Buffer::Rotate(const I420BufferInterface& src, VideoRotation rotation)
+{
+    RTC_CHECK(src.DataY());
+    RTC_CHECK(src.DataU());
+    RTC_CHECK(src.DataV());
+
+    int rotated_width = src.width();
+    int rotated_height = src.height();
+    if (rotation == kVideoRotation_90 || rotation == kVideoRotation_270) {
+        std::swap(rotated_width, rotated_height);
+    }
+
+    rtc::scoped_refptr<I420Buffer> buffer = Create(rotated_width, rotated_height);
+    RTC_CHECK_EQ(0, libyuv::I420Rotate(src.DataY(), src.StrideY(), src.DataU(), src.StrideU(), src.DataV(),
+                        src.StrideV(), buffer->MutableDataY(), buffer->StrideY(), buffer->MutableDataU(),
+                        buffer->StrideU(), buffer->MutableDataV(), buffer->StrideV(), src.width(), src.height(),
+                        static_cast<libyuv::RotationMode>(rotation)));
+    return buffer;
+}
+
+void I420Buffer::InitializeData()
+{
+    memset(data_.get(), 0, I420DataSize(height_, stride_y_, stride_u_, stride_v_));
+}
+
+int I420Buffer::width() const
+{
+    return width_;
+}
+
+int I420Buffer::height() const
+{
+    return height_;
+}
+
+const uint8_t* I420Buffer::DataY() const
+{
+    return data_.get();
+}
+
+const uint8_t* I420Buffer::DataU() const
+{
+    return data_.get() + stride_y_ * height_;
+}
+
+const uint8_t* I420Buffer::DataV() const
+{
+    return data_.get() + stride_y_ * height_ + stride_u_ * ((height_ + 1) / 2);
+}
+
+int I420Buffer::StrideY() const
+{
+    return stride_y_;
+}
+
+int I420Buffer::StrideU() const
+{
+    return stride_u_;
+}
+
+int I420Buffer::StrideV() const
+{
+    return stride_v_;
+}
+
+uint8_t* I420Buffer::MutableDataY()
+{
+    return const_cast<uint8_t*>(DataY());
+}
+
+uint8_t* I420Buffer::MutableDataU()
+{
+    return const_cast<uint8_t*>(DataU());
+}
+
+uint8_t* I420Buffer::MutableDataV()
+{
+    return const_cast<uint8_t*>(DataV());
+}
+
+void I420Buffer::SetBlack(I420Buffer* buffer)
+{
+    RTC_CHECK(libyuv::I420Rect(buffer->MutableDataY(), buffer->StrideY(), buffer->MutableDataU(), buffer->StrideU(),
+                  buffer->MutableDataV(), buffer->StrideV(), 0, 0, buffer->width(), buffer->height(), 0, 128,
+                  128) == 0);
+}
+
+void I420Buffer::CropAndScaleFrom(
+    const I420BufferInterface& src, int offset_x, int offset_y, int crop_width, int crop_height)
+{
+    RTC_CHECK_LE(crop_width, src.width());
+    RTC_CHECK_LE(crop_height, src.height());
+    RTC_CHECK_LE(crop_width + offset_x, src.width());
+    RTC_CHECK_LE(crop_height + offset_y, src.height());
+    RTC_CHECK_GE(offset_x, 0);
+    RTC_CHECK_GE(offset_y, 0);
+
+    // make sure offset is even so that u/v plane becomes aligned
+    const int uv_offset_x = offset_x / 2;
+    const int uv_offset_y = offset_y / 2;
+    offset_x = uv_offset_x * 2;
+    offset_y = uv_offset_y * 2;
+
+    const uint8_t* y_plane = src.DataY() + src.StrideY() * offset_y + offset_x;
+    const uint8_t* u_plane = src.DataU() + src.StrideU() * uv_offset_y + uv_offset_x;
+    const uint8_t* v_plane = src.DataV() + src.StrideV() * uv_offset_y + uv_offset_x;
+    int res = libyuv::I420Scale(y_plane, src.StrideY(), u_plane, src.StrideU(), v_plane, src.StrideV(), crop_width,
+        crop_height, MutableDataY(), StrideY(), MutableDataU(), StrideU(), MutableDataV(), StrideV(), width(),
+        height(), libyuv::kFilterBox);
+    RTC_DCHECK_EQ(res, 0);
+}
+
+void I420Buffer::CropAndScaleFrom(const I420BufferInterface& src)
+{
+    const int crop_width = height() > 0 ? std::min(src.width(), width() * src.height() / height()) : src.width();
+    const int crop_height = width() > 0 ? std::min(src.height(), height() * src.width() / width()) : src.height();
+
+    CropAndScaleFrom(src, (src.width() - crop_width) / 2, (src.height() - crop_height) / 2, crop_width, crop_height);
+}
+
+void I420Buffer::ScaleFrom(const I420BufferInterface& src)
+{
+    CropAndScaleFrom(src, 0, 0, src.width(), src.height());
+}
+
+// NV12Buffer
+
+NV12Buffer::NV12Buffer(int width, int height) : NV12Buffer(width, height, width, width + width % 2) {}
+
+NV12Buffer::NV12Buffer(int width, int height, int stride_y, int stride_uv)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_uv_(stride_uv),
+      data_(static_cast<uint8_t*>(AlignedMalloc(NV12DataSize(height_, stride_y_, stride_uv), kBufferAlignment)))
+{
+    RTC_DCHECK_GT(width, 0);
+    RTC_DCHECK_GT(height, 0);
+    RTC_DCHECK_GE(stride_y, width);
+    RTC_DCHECK_GE(stride_uv, (width + width % 2));
+}
+
+NV12Buffer::~NV12Buffer() = default;
+
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width, int height)
+{
+    return rtc::make_ref_counted<NV12Buffer>(width, height);
+}
+
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width, int height, int stride_y, int stride_uv)
+{
+    return rtc::make_ref_counted<NV12Buffer>(width, height, stride_y, stride_uv);
+}
+
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(const I420BufferInterface& i420_buffer)
+{
+    rtc::scoped_refptr<NV12Buffer> buffer = NV12Buffer::Create(i420_buffer.width(), i420_buffer.height());
+    libyuv::I420ToNV12(i420_buffer.DataY(), i420_buffer.StrideY(), i420_buffer.DataU(), i420_buffer.StrideU(),
+        i420_buffer.DataV(), i420_buffer.StrideV(), buffer->MutableDataY(), buffer->StrideY(), buffer->MutableDataUV(),
+        buffer->StrideUV(), buffer->width(), buffer->height());
+    return buffer;
+}
+
+rtc::scoped_refptr<I420BufferInterface> NV12Buffer::ToI420()
+{
+    rtc::scoped_refptr<I420Buffer> i420_buffer = I420Buffer::Create(width(), height());
+    libyuv::NV12ToI420(DataY(), StrideY(), DataUV(), StrideUV(), i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+        i420_buffer->MutableDataU(), i420_buffer->StrideU(), i420_buffer->MutableDataV(), i420_buffer->StrideV(),
+        width(), height());
+    return i420_buffer;
+}
+
+int NV12Buffer::width() const
+{
+    return width_;
+}
+
+int NV12Buffer::height() const
+{
+    return height_;
+}
+
+int NV12Buffer::StrideY() const
+{
+    return stride_y_;
+}
+
+int NV12Buffer::StrideUV() const
+{
+    return stride_uv_;
+}
+
+const uint8_t* NV12Buffer::DataY() const
+{
+    return data_.get();
+}
+
+const uint8_t* NV12Buffer::DataUV() const
+{
+    return data_.get() + UVOffset();
+}
+
+uint8_t* NV12Buffer::MutableDataY()
+{
+    return data_.get();
+}
+
+uint8_t* NV12Buffer::MutableDataUV()
+{
+    return data_.get() + UVOffset();
+}
+
+size_t NV12Buffer::UVOffset() const
+{
+    return stride_y_ * height_;
+}
+
+void NV12Buffer::InitializeData()
+{
+    memset(data_.get(), 0, NV12DataSize(height_, stride_y_, stride_uv_));
+}
+
+void NV12Buffer::CropAndScaleFrom(
+    const NV12BufferInterface& src, int offset_x, int offset_y, int crop_width, int crop_height)
+{
+    RTC_CHECK_LE(crop_width, src.width());
+    RTC_CHECK_LE(crop_height, src.height());
+    RTC_CHECK_LE(crop_width + offset_x, src.width());
+    RTC_CHECK_LE(crop_height + offset_y, src.height());
+    RTC_CHECK_GE(offset_x, 0);
+    RTC_CHECK_GE(offset_y, 0);
+
+    // make sure offset is even so that u/v plane becomes aligned
+    const int uv_offset_x = offset_x / 2;
+    const int uv_offset_y = offset_y / 2;
+    offset_x = uv_offset_x * 2;
+    offset_y = uv_offset_y * 2;
+
+    const uint8_t* y_plane = src.DataY() + src.StrideY() * offset_y + offset_x;
+    const uint8_t* uv_plane = src.DataUV() + src.StrideUV() * uv_offset_y + uv_offset_x * 2;
+
+    int res = libyuv::NV12Scale(y_plane, src.StrideY(), uv_plane, src.StrideUV(), crop_width, crop_height,
+        MutableDataY(), StrideY(), MutableDataUV(), StrideUV(), width(), height(), libyuv::kFilterBox);
+    RTC_DCHECK_EQ(res, 0);
+}
+
+} // namespace webrtc
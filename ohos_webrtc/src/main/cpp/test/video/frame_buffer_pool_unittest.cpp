@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "video/frame_buffer_pool.h"
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "api/video/video_frame_buffer.h"
+
+namespace webrtc {
+
+namespace {
+
+// Produce frames the way the capture and decode paths do, and keep the last few of them like a renderer or the
+// encoder queue would.
+class SyntheticFrameSource {
+public:
+    SyntheticFrameSource(FrameBufferPool& pool, VideoFrameBuffer::Type type, size_t heldFrames)
+        : pool_(pool), type_(type), heldFrames_(heldFrames)
+    {
+    }
+
+    rtc::scoped_refptr<VideoFrameBuffer> NextFrame(int width, int height)
+    {
+        rtc::scoped_refptr<VideoFrameBuffer> buffer;
+        if (type_ == VideoFrameBuffer::Type::kNV12) {
+            auto nv12Buffer = pool_.CreateNV12Buffer(width, height);
+            memset(nv12Buffer->MutableDataY(), static_cast<uint8_t>(frameCount_), nv12Buffer->StrideY() * height);
+            buffer = nv12Buffer;
+        } else {
+            auto i420Buffer = pool_.CreateI420Buffer(width, height);
+            memset(i420Buffer->MutableDataY(), static_cast<uint8_t>(frameCount_), i420Buffer->StrideY() * height);
+            buffer = i420Buffer;
+        }
+
+        frameCount_++;
+        held_.push_back(buffer);
+        if (held_.size() > heldFrames_) {
+            held_.pop_front();
+        }
+
+        return buffer;
+    }
+
+    void DropHeldFrames()
+    {
+        held_.clear();
+    }
+
+private:
+    FrameBufferPool& pool_;
+    const VideoFrameBuffer::Type type_;
+    const size_t heldFrames_;
+
+    std::deque<rtc::scoped_refptr<VideoFrameBuffer>> held_;
+    int64_t frameCount_{0};
+};
+
+} // namespace
+
+TEST(FrameBufferPoolTest, RecyclesBuffersOnceReleased)
+{
+    FrameBufferPool pool;
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kI420, 2);
+
+    for (int i = 0; i < 100; i++) {
+        source.NextFrame(640, 480);
+    }
+
+    // two frames held by the sink, plus the one being produced
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.hits, 97u);
+    EXPECT_EQ(stats.bufferCount, 3u);
+    EXPECT_EQ(stats.highWater, 3u);
+    EXPECT_EQ(stats.inUseCount, 2u);
+
+    source.DropHeldFrames();
+    EXPECT_EQ(pool.GetStats().inUseCount, 0u);
+}
+
+TEST(FrameBufferPoolTest, DoesNotHandOutBuffersInUse)
+{
+    FrameBufferPool pool;
+
+    auto first = pool.CreateI420Buffer(320, 240);
+    auto second = pool.CreateI420Buffer(320, 240);
+    EXPECT_NE(first.get(), second.get());
+
+    auto* released = second.get();
+    second = nullptr;
+    EXPECT_EQ(pool.CreateI420Buffer(320, 240).get(), released);
+}
+
+TEST(FrameBufferPoolTest, KeysBuffersByFormat)
+{
+    FrameBufferPool pool;
+
+    auto i420Buffer = pool.CreateI420Buffer(320, 240);
+    i420Buffer = nullptr;
+    auto nv12Buffer = pool.CreateNV12Buffer(320, 240);
+    EXPECT_EQ(nv12Buffer->type(), VideoFrameBuffer::Type::kNV12);
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.bufferCount, 2u);
+}
+
+TEST(FrameBufferPoolTest, AllocatesOutsideOfThePoolBeyondTheLimit)
+{
+    FrameBufferPool pool(2, 8);
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kNV12, 10);
+
+    for (int i = 0; i < 10; i++) {
+        auto buffer = source.NextFrame(320, 240);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(buffer->width(), 320);
+    }
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.bufferCount, 2u);
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 10u);
+}
+
+TEST(FrameBufferPoolTest, KeepsOtherSizesOnResolutionChange)
+{
+    FrameBufferPool pool;
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kI420, 0);
+
+    // alternate between the capture resolution and an adapted one
+    for (int i = 0; i < 50; i++) {
+        source.NextFrame(1280, 720);
+        source.NextFrame(640, 360);
+    }
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.hits, 98u);
+    EXPECT_EQ(stats.bufferCount, 2u);
+}
+
+TEST(FrameBufferPoolTest, TrimsLeastRecentlyUsedSizes)
+{
+    FrameBufferPool pool(16, 2);
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kI420, 0);
+
+    source.NextFrame(320, 240);
+    source.NextFrame(640, 480);
+    source.NextFrame(320, 240);
+    source.NextFrame(1280, 720);
+
+    // 640x480 was purged, the buffer has to be allocated again
+    source.NextFrame(640, 480);
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.misses, 4u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.bufferCount, 2u);
+}
+
+TEST(FrameBufferPoolTest, ReleaseKeepsBuffersInUse)
+{
+    FrameBufferPool pool;
+
+    auto held = pool.CreateI420Buffer(320, 240);
+    pool.CreateI420Buffer(320, 240);
+    EXPECT_EQ(pool.GetStats().bufferCount, 2u);
+
+    pool.Release();
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.bufferCount, 1u);
+    EXPECT_EQ(stats.inUseCount, 1u);
+}
+
+TEST(FrameBufferPoolTest, BoundsTheBytesOfTheBuffers)
+{
+    // room for two 640x480 I420 buffers
+    FrameBufferPool pool(16, 8, 640 * 480 * 3);
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kI420, 3);
+
+    for (int i = 0; i < 10; i++) {
+        source.NextFrame(640, 480);
+    }
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.bufferCount, 2u);
+    EXPECT_EQ(stats.highWater, 2u);
+    EXPECT_EQ(stats.byteCount, 640u * 480 * 3 / 2 * 2);
+}
+
+TEST(FrameBufferPoolTest, MakesRoomWithTheFreeBuffersOfOtherSizes)
+{
+    FrameBufferPool pool(16, 8, 640 * 480 * 3 / 2);
+    SyntheticFrameSource source(pool, VideoFrameBuffer::Type::kI420, 0);
+
+    source.NextFrame(640, 480);
+    source.NextFrame(320, 240);
+    source.NextFrame(320, 240);
+
+    // the free 640x480 buffer was dropped for the 320x240 one
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.bufferCount, 1u);
+    EXPECT_EQ(stats.byteCount, 320u * 240 * 3 / 2);
+    EXPECT_EQ(stats.hits, 1u);
+}
+
+TEST(FrameBufferPoolTest, ReleasesIdleSizes)
+{
+    FrameBufferPool pool(16, 8, FrameBufferPool::kMaxBytes_Default, 20);
+
+    auto held = pool.CreateI420Buffer(1280, 720);
+    pool.CreateI420Buffer(1280, 720);
+    EXPECT_EQ(pool.GetStats().bufferCount, 2u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pool.CreateI420Buffer(320, 240);
+
+    // the free 1280x720 buffer is dropped, the one in use is kept
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.bufferCount, 2u);
+    EXPECT_EQ(stats.inUseCount, 1u);
+    EXPECT_EQ(stats.byteCount, 1280u * 720 * 3 / 2 + 320u * 240 * 3 / 2);
+}
+
+} // namespace webrtc
@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2024 Archermind Technology (Nanjing) Co. Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "video/native_buffer_frame_buffer.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "fake_native_image.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 32;
+
+class NativeBufferFrameBufferTest : public ::testing::Test {
+protected:
+    rtc::scoped_refptr<NativeBufferFrameBuffer> Create(FakeNativeImage& image)
+    {
+        return NativeBufferFrameBuffer::Create(
+            image.image(), image.buffer(), CreateFakeImageReceiver([] {}), heldImageCount_);
+    }
+
+    // each luma row is filled with its index, the chroma with 128
+    static void FillNV12(FakeNativeImage& image)
+    {
+        for (int row = 0; row < kHeight; row++) {
+            memset(image.data() + row * image.stride(), row, kWidth);
+        }
+        memset(image.data() + kWidth * kHeight, 128, kWidth * kHeight / 2);
+    }
+
+    std::shared_ptr<std::atomic<int32_t>> heldImageCount_ = std::make_shared<std::atomic<int32_t>>(0);
+};
+
+} // namespace
+
+TEST_F(NativeBufferFrameBufferTest, ConvertsNV12ToI420)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+    FillNV12(image);
+
+    auto buffer = Create(image);
+    EXPECT_EQ(buffer->type(), VideoFrameBuffer::Type::kNative);
+    EXPECT_EQ(buffer->width(), kWidth);
+    EXPECT_EQ(buffer->height(), kHeight);
+
+    auto i420Buffer = buffer->ToI420();
+    ASSERT_NE(i420Buffer, nullptr);
+    for (int row = 0; row < kHeight; row++) {
+        EXPECT_EQ(i420Buffer->DataY()[row * i420Buffer->StrideY()], row);
+    }
+    EXPECT_EQ(i420Buffer->DataU()[0], 128);
+    EXPECT_EQ(i420Buffer->DataV()[0], 128);
+}
+
+TEST_F(NativeBufferFrameBufferTest, ReleasesImageWithLastReference)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+
+    auto buffer = Create(image);
+    EXPECT_EQ(heldImageCount_->load(), 1);
+
+    buffer->ToI420();
+    buffer->ToI420();
+    EXPECT_EQ(image.mapCount(), 1);
+
+    auto cropped = buffer->CropAndScale(0, 0, kWidth / 2, kHeight / 2, kWidth / 2, kHeight / 2);
+    buffer = nullptr;
+    EXPECT_FALSE(image.released());
+    EXPECT_EQ(heldImageCount_->load(), 1);
+
+    cropped = nullptr;
+    EXPECT_TRUE(image.released());
+    EXPECT_EQ(image.unmapCount(), 1);
+    EXPECT_EQ(heldImageCount_->load(), 0);
+}
+
+TEST_F(NativeBufferFrameBufferTest, DoesNotMapUntilPixelsAreRead)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+
+    auto buffer = Create(image);
+    buffer->CropAndScale(0, 0, kWidth, kHeight, kWidth / 2, kHeight / 2);
+    buffer = nullptr;
+
+    EXPECT_TRUE(image.released());
+    EXPECT_EQ(image.mapCount(), 0);
+    EXPECT_EQ(image.unmapCount(), 0);
+}
+
+TEST_F(NativeBufferFrameBufferTest, MapsNV12WithoutCopy)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+
+    auto buffer = Create(image);
+    VideoFrameBuffer::Type types[] = {VideoFrameBuffer::Type::kNV12};
+    auto mapped = buffer->GetMappedFrameBuffer(types);
+    ASSERT_NE(mapped, nullptr);
+    ASSERT_EQ(mapped->type(), VideoFrameBuffer::Type::kNV12);
+
+    const auto* nv12Buffer = mapped->GetNV12();
+    EXPECT_EQ(nv12Buffer->DataY(), image.data());
+    EXPECT_EQ(nv12Buffer->DataUV(), image.data() + kWidth * kHeight);
+
+    // the view keeps the image mapped
+    buffer = nullptr;
+    EXPECT_FALSE(image.released());
+    mapped = nullptr;
+    EXPECT_TRUE(image.released());
+}
+
+TEST_F(NativeBufferFrameBufferTest, CropsAtEvenOffsets)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+    FillNV12(image);
+
+    auto buffer = Create(image);
+    auto cropped = buffer->CropAndScale(3, 3, kWidth / 2, kHeight / 2, kWidth / 2, kHeight / 2);
+    EXPECT_EQ(image.mapCount(), 0);
+    EXPECT_EQ(cropped->width(), kWidth / 2);
+    EXPECT_EQ(cropped->height(), kHeight / 2);
+
+    auto i420Buffer = cropped->ToI420();
+    ASSERT_NE(i420Buffer, nullptr);
+    EXPECT_EQ(i420Buffer->DataY()[0], 2);
+
+    auto scaled = buffer->CropAndScale(0, 0, kWidth, kHeight, kWidth / 4, kHeight / 4);
+    auto scaledI420Buffer = scaled->ToI420();
+    ASSERT_NE(scaledI420Buffer, nullptr);
+    EXPECT_EQ(scaledI420Buffer->width(), kWidth / 4);
+    EXPECT_EQ(scaledI420Buffer->height(), kHeight / 4);
+}
+
+TEST_F(NativeBufferFrameBufferTest, ConvertsRGBAWithPaddedStride)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_RGBA_8888);
+    ASSERT_GT(image.stride(), kWidth * 4);
+
+    // white pixels, and garbage in the padding
+    memset(image.data(), 0, image.stride() * kHeight);
+    for (int row = 0; row < kHeight; row++) {
+        memset(image.data() + row * image.stride(), 0xff, kWidth * 4);
+    }
+
+    auto i420Buffer = Create(image)->ToI420();
+    ASSERT_NE(i420Buffer, nullptr);
+    for (int row = 0; row < kHeight; row++) {
+        EXPECT_NEAR(i420Buffer->DataY()[row * i420Buffer->StrideY() + kWidth - 1], 235, 1);
+    }
+}
+
+// VideoFrameDrawer skips such frames
+TEST_F(NativeBufferFrameBufferTest, FailsToConvertUnsupportedFormat)
+{
+    FakeNativeImage image(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCRCB_420_SP);
+
+    auto buffer = Create(image);
+    EXPECT_EQ(buffer->ToI420(), nullptr);
+    buffer = nullptr;
+
+    EXPECT_TRUE(image.released());
+    EXPECT_EQ(image.mapCount(), image.unmapCount());
+}
+
+TEST_F(NativeBufferFrameBufferTest, KeepsReceiverAliveUntilLastImageIsReleased)
+{
+    FakeNativeImage first(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+    FakeNativeImage second(kWidth, kHeight, NATIVEBUFFER_PIXEL_FMT_YCBCR_420_SP);
+
+    bool receiverReleased = false;
+    bool imagesReleasedFirst = false;
+    auto receiver = CreateFakeImageReceiver([&] {
+        receiverReleased = true;
+        imagesReleasedFirst = first.released() && second.released();
+    });
+
+    auto firstBuffer = NativeBufferFrameBuffer::Create(first.image(), first.buffer(), receiver, heldImageCount_);
+    auto secondBuffer = NativeBufferFrameBuffer::Create(second.image(), second.buffer(), receiver, heldImageCount_);
+
+    // the video frame receiver drops its handle, e.g. on a size change
+    receiver = nullptr;
+    EXPECT_FALSE(receiverReleased);
+
+    firstBuffer = nullptr;
+    EXPECT_FALSE(receiverReleased);
+
+    secondBuffer = nullptr;
+    EXPECT_TRUE(receiverReleased);
+    EXPECT_TRUE(imagesReleasedFirst);
+}
+
+} // namespace webrtc
@@ -262,11 +262,57 @@ export interface RTCDataChannel {
   send(data: ArrayBuffer): void;
 }
 
+// extension for data channel in OpenHarmony
+export interface RTCDataChannel {
+  // Bytes of received messages copied on the way to ArkTS values: all text messages, plus binary messages whose
+  // buffer was still shared and had to be detached. Binary messages are normally delivered without copy.
+  readonly receivedBytesCopied: number;
+  // Number of pending events superseded by a newer event of the same type, such as bufferedamountlow. An event is only
+  // superseded when no other event was dispatched in between, so the order of the events is kept.
+  readonly coalescedEventCount: number;
+
+  // Send all messages at once, the state is checked once for the whole batch.
+  sendMany(data: (string | ArrayBuffer | ArrayBufferView)[]): void;
+  // Send consecutive slices of data as separate messages, one message per entry of lengths.
+  sendMany(data: ArrayBuffer | ArrayBufferView, lengths: number[]): void;
+  // Create a writer with native flow control, any previous writer of this channel is closed.
+  createWriter(options?: RTCDataChannelWriterOptions): RTCDataChannelWriter;
+}
+
 declare var RTCDataChannel: {
   prototype: RTCDataChannel;
   new(): RTCDataChannel;
 };
 
+// extension for data channel in OpenHarmony
+export interface RTCDataChannelWriterOptions {
+  // Size of each message, default is 65536. Must not be greater than RTCSctpTransport.maxMessageSize (or 262144
+  // before it is known), and messages are clamped to RTCSctpTransport.maxMessageSize once it is negotiated.
+  chunkSize?: number;
+  // Sending is paused when bufferedAmount reaches this value, default is 1048576.
+  highWaterMark?: number;
+  // Sending is resumed when bufferedAmount drops to this value, default is 262144.
+  lowWaterMark?: number;
+}
+
+// extension for data channel in OpenHarmony
+export interface RTCDataChannelWriter {
+  readonly chunkSize: number;
+  readonly highWaterMark: number;
+  readonly lowWaterMark: number;
+  // Bytes written but not yet handed to the data channel.
+  readonly pendingBytes: number;
+  readonly paused: boolean;
+
+  // Resolved when all the data has been accepted by the data channel. Rejected with the error of the first chunk
+  // failing to send, which also closes the writer.
+  write(data: ArrayBuffer | ArrayBufferView): Promise<void>;
+  // Resolved when everything written before has been sent and bufferedAmount dropped to zero.
+  flush(): Promise<void>;
+  // Pending writes are rejected.
+  close(): void;
+}
+
 // https://www.w3.org/TR/webrtc/#dom-rtcdatachannelinit
 export interface RTCDataChannelInit {
   ordered?: boolean;
@@ -354,10 +400,52 @@ export interface RTCPeerConnection extends EventTarget {
   addTransceiver(trackOrKind: MediaStreamTrack | string, init?: RTCRtpTransceiverInit): RTCRtpTransceiver;
   close(): void;
   getStats(selector?: MediaStreamTrack): Promise<RTCStatsReport>;
+  getStats(options: RTCStatsOptions & { format: 'binary' }): Promise<ArrayBuffer>;
+  getStats(options: RTCStatsOptions): Promise<RTCStatsReport>;
   setAudioRecording(recording: boolean): void;
   setAudioPlayout(playout: boolean): void;
 }
 
+// extension for event coalescing in OpenHarmony
+export interface RTCPeerConnection {
+  // Number of pending state change events superseded by a newer event of the same type, with no other event in between.
+  readonly coalescedEventCount: number;
+}
+
+// extension for stats sampling in OpenHarmony
+export interface RTCPeerConnection {
+  // Collect stats natively every interval and keep the values of series in a ring buffer, any running sampler
+  // is replaced.
+  startStatsSampler(options: RTCStatsSamplerOptions): void;
+  stopStatsSampler(): void;
+  // Return at most maxCount latest samples, oldest first. Each sample is series.length + 1 values: the timestamp
+  // in milliseconds followed by the value of each series, NaN if not available.
+  readStatsSamples(maxCount?: number): Float64Array;
+}
+
+// extension for stats sampling in OpenHarmony
+export interface RTCStatsSeries {
+  // stats type, such as 'outbound-rtp'
+  type: string;
+  // numeric member, such as 'bytesSent'
+  name: string;
+  // how the values are combined when there are several stats of the type, default is 'sum'
+  aggregation?: 'sum' | 'min' | 'max' | 'average';
+  // per-second rate between two samples instead of the value itself, default is false
+  rate?: boolean;
+  // multiplier applied to the value, such as 8 for bitrate from bytesSent, default is 1
+  scale?: number;
+}
+
+// extension for stats sampling in OpenHarmony
+export interface RTCStatsSamplerOptions {
+  // in milliseconds, at least 10, default is 1000
+  interval?: number;
+  // number of samples kept, default is 600
+  capacity?: number;
+  series: RTCStatsSeries[];
+}
+
 declare var RTCPeerConnection: {
   prototype: RTCPeerConnection;
   new(configuration?: RTCConfiguration): RTCPeerConnection;
@@ -573,6 +661,12 @@ export interface RTCIceTransport extends EventTarget {
   getSelectedCandidatePair(): RTCIceCandidatePair | null;
 }
 
+// extension for event coalescing in OpenHarmony
+export interface RTCIceTransport {
+  // Number of pending state change events superseded by a newer event of the same type, with no other event in between.
+  readonly coalescedEventCount: number;
+}
+
 declare var RTCIceTransport: {
   prototype: RTCIceTransport;
   new(): RTCIceTransport;
@@ -611,6 +705,23 @@ export interface RTCStatsReport {
   readonly stats: Map<string, RTCStats>;
   // readonly timestamp: HighResTimeStamp; // android
   // forEach(callback: (value: RTCStats, key: string, parent: RTCStatsReport) => void): void;
+
+  // extension for delta stats in OpenHarmony
+  // Set when getStats is called with options. True if only the changes since the previous delta report are
+  // contained, in which case stats also carry per-second rates such as sendBitrate, receiveBitrate,
+  // packetsLostPerSecond, framesEncodedPerSecond and packetLossRatio.
+  readonly delta?: boolean;
+  // Ids of the stats which are gone since the previous delta report.
+  readonly removed?: string[];
+}
+
+// extension for delta stats in OpenHarmony
+export interface RTCStatsOptions {
+  // The first delta report of a peer connection is a full one.
+  delta?: boolean;
+  // 'binary' resolves with a single ArrayBuffer instead of RTCStatsReport: a string table followed by the stats
+  // grouped by type into Float64 columns, see stats/stats_binary_writer.h for the layout. Default is 'object'.
+  format?: 'object' | 'binary';
 }
 
 // https://www.w3.org/TR/webrtc-stats/#dom-rtctransportstats
@@ -891,11 +1002,81 @@ export interface AudioCapturerSamplesReadyEvent extends Event {
   readonly samples: AudioSamples;
 }
 
+// level of the audio samples last processed
+export interface AudioLevel {
+  // linear, from 0 to 1 of full scale
+  readonly rms: number;
+  readonly peak: number;
+
+  // estimated from the energy, held for a short while after the voice stops
+  readonly voiceActive: boolean;
+}
+
+export interface AudioLevels {
+  // of the recorded samples, zero when not recording
+  readonly input: AudioLevel;
+
+  // of the played samples, zero when not playing
+  readonly output: AudioLevel;
+}
+
+export interface AudioLevelEvent extends Event, AudioLevels {
+}
+
+export interface AudioGlitch {
+  // wall clock in milliseconds
+  readonly timestamp: number;
+
+  // 'underrun': the renderer ran out of samples, value is the number of underruns
+  // 'overrun': the capturer dropped samples, value is the number of overruns
+  // 'late-callback': the callback came more than a period late, value is the interval in microseconds
+  // 'slow-callback': the callback took longer than a period, value is its duration in microseconds
+  readonly type: 'underrun' | 'overrun' | 'late-callback' | 'slow-callback';
+  readonly value: number;
+}
+
+// Histograms have power of two buckets: bucket 0 counts 0, bucket i counts [2^(i-1), 2^i),
+// and the last bucket everything above.
+export interface AudioCallbackStats {
+  // label of the audio input, empty for the playout and the mix
+  readonly label: string;
+  readonly callbackCount: number;
+
+  // in microseconds
+  readonly intervalHistogram: number[];
+  readonly durationHistogram: number[];
+
+  // audio queued in the stream, in milliseconds
+  readonly fillHistogram: number[];
+
+  readonly glitchCount: number;
+  // the most recent ones, oldest first
+  readonly recentGlitches: AudioGlitch[];
+}
+
+export interface AudioMixingSourceStats {
+  readonly label: string;
+  // 10 ms frames which the input could not fill in time, concealed with silence
+  readonly underrunCount: number;
+  // writes of the input which did not fit in its fifo, the rest of them were dropped
+  readonly overrunCount: number;
+}
+
+export interface AudioCallbackStatsReport {
+  readonly playout?: AudioCallbackStats;
+  // the 10 ms ticks of the mixing, when several inputs are mixed
+  readonly mix?: AudioCallbackStats;
+  readonly capture: AudioCallbackStats[];
+  // the fifos of the inputs of the mixing, empty when the inputs are not mixed
+  readonly sources: AudioMixingSourceStats[];
+}
+
 export interface AudioDeviceModuleOptions {
   // input source. see ohos.multimedia.audio.SourceType, default is SOURCE_TYPE_VOICE_COMMUNICATION.
   audioSource?: number;
 
   // input format. see ohos.multimedia.audio.AudioSampleFormat, default SAMPLE_FORMAT_S16LE.
+  // SAMPLE_FORMAT_S16LE, SAMPLE_FORMAT_S32LE and SAMPLE_FORMAT_F32LE are supported.
   audioFormat?: number;
 
   // input sample rate, default is 48000.
@@ -916,6 +1097,13 @@ export interface AudioDeviceModuleOptions {
   // enable low latency capturing and rendering, default is false
   useLowLatency?: boolean;
 
+  // duration of the native capturing and rendering buffers in milliseconds.
+  // default is 5 with useLowLatency, otherwise decided by the system.
+  audioBufferDuration?: number;
+
+  // minimum interval of onaudiolevel in milliseconds, default is 100.
+  audioLevelInterval?: number;
+
   // Control if the built-in HW acoustic echo canceler should be used or not, default is false.
   // It is possible to query support by calling AudioDeviceModule.isBuiltInAcousticEchoCancelerSupported()
   useHardwareAcousticEchoCanceler?: boolean;
@@ -937,6 +1125,47 @@ export interface AudioSamples {
 
   // audio data
   readonly data: ArrayBuffer;
+
+  // Only present on pooled events with manualRelease. Returns the buffer to the pool, data must not be used after.
+  release?(): void;
+}
+
+// all in milliseconds
+export interface AudioDelayStats {
+  // from the capture of a sample to its delivery to webrtc
+  readonly recordDelay: number;
+
+  // from the request of a sample by the renderer to its playout
+  readonly playoutDelay: number;
+
+  // recordDelay + playoutDelay, the sum of the two one-way delays, which the echo canceller is told as the render to
+  // capture delay. It is not measured end to end, the acoustic path from the speaker to the microphone is not included.
+  readonly combinedDelay: number;
+}
+
+export interface AudioSamplesEventOptions {
+  // deliver the samples in a fixed set of reused buffers, default is false.
+  // the data of a pooled event is only valid during the call of the handler, copy what needs to be kept, unless
+  // manualRelease is set.
+  pooled?: boolean;
+
+  // keep each pooled buffer out of the pool until samples.release() is called, instead of reusing it once the
+  // handler returns, default is false. samples are discarded while all the buffers are held.
+  manualRelease?: boolean;
+
+  // number of pooled buffers, default is 4. samples are discarded when all of them are in use.
+  bufferCount?: number;
+
+  // duration of the samples in one pooled event in milliseconds, default is 10.
+  interval?: number;
+}
+
+export interface AudioSamplesEventStats {
+  // events which could not be queued to the js thread
+  readonly droppedCount: number;
+
+  // captured samples discarded because no pooled buffer was free
+  readonly overflowCount: number;
 }
 
 export interface AudioDeviceModule {
@@ -946,10 +1175,25 @@ export interface AudioDeviceModule {
   oncapturersamplesready: ((this: any, event: AudioCapturerSamplesReadyEvent) => void) | null;
   onrenderererror: ((this: any, event: AudioErrorEvent) => void) | null;
   onrendererstatechange: ((this: any, event: AudioStateChangeEvent) => void) | null;
+  // Called periodically with the audio levels while recording, see AudioDeviceModuleOptions.audioLevelInterval
+  onaudiolevel: ((this: any, event: AudioLevelEvent) => void) | null;
 
   setSpeakerMute(mute: boolean): void;
   setMicrophoneMute(mute: boolean): void;
   setNoiseSuppressorEnabled(enabled: boolean): boolean;
+
+  // delays measured on the native capturing and rendering
+  getDelayStats(): AudioDelayStats;
+
+  // control how oncapturersamplesready is delivered
+  setSamplesEventOptions(options: AudioSamplesEventOptions): void;
+  getSamplesEventStats(): AudioSamplesEventStats;
+
+  // levels measured on the native capturing and rendering
+  getAudioLevels(): AudioLevels;
+
+  // telemetry of the native audio callbacks, to tell dropouts of the system from deadlines missed by webrtc
+  getCallbackStats(): AudioCallbackStatsReport;
 }
 
 declare var AudioDeviceModule: {
@@ -959,11 +1203,77 @@ declare var AudioDeviceModule: {
   isBuiltInNoiseSuppressorSupported(): boolean;
 };
 
+// Mirror of webrtc::AudioProcessing::Config, see modules/audio_processing/include/audio_processing.h.
+// Missing fields keep their current value, or the native default when creating.
+// The voice engine writes highPassFilter, echoCanceller, noiseSuppression and gainController1 from the audio options of
+// the sources, when it starts and whenever the options of a sending track change. Those of these groups which were
+// given to create() or applyConfig() are kept over the audio options, the other groups follow the audio options.
+export interface AudioProcessingConfig {
+  pipeline?: {
+    // 32000 or 48000, a lower rate saves cpu
+    maximumInternalProcessingRate?: number;
+    multiChannelRender?: boolean;
+    // process stereo capture without downmixing, needs AudioDeviceModuleOptions.useStereoInput
+    multiChannelCapture?: boolean;
+    captureDownmixMethod?: 'average-channels' | 'use-first-channel';
+  };
+  preAmplifier?: {
+    enabled?: boolean;
+    fixedGainFactor?: number;
+  };
+  highPassFilter?: {
+    enabled?: boolean;
+    applyInFullBand?: boolean;
+  };
+  echoCanceller?: {
+    enabled?: boolean;
+    // use AECM instead of AEC3, much cheaper and of lower quality
+    mobileMode?: boolean;
+    enforceHighPassFiltering?: boolean;
+  };
+  noiseSuppression?: {
+    enabled?: boolean;
+    level?: 'low' | 'moderate' | 'high' | 'very-high';
+  };
+  transientSuppression?: {
+    enabled?: boolean;
+  };
+  gainController1?: {
+    enabled?: boolean;
+    mode?: 'adaptive-analog' | 'adaptive-digital' | 'fixed-digital';
+    targetLevelDbfs?: number;
+    compressionGainDb?: number;
+    enableLimiter?: boolean;
+  };
+  gainController2?: {
+    enabled?: boolean;
+    inputVolumeController?: {
+      enabled?: boolean;
+    };
+    adaptiveDigital?: {
+      enabled?: boolean;
+      headroomDb?: number;
+      maxGainDb?: number;
+      initialGainDb?: number;
+      maxGainChangeDbPerSecond?: number;
+      maxOutputNoiseLevelDbfs?: number;
+    };
+    fixedDigital?: {
+      gainDb?: number;
+    };
+  };
+}
+
 // Hold a native webrtc.AudioProcessing instance
-export interface AudioProcessing {}
+export interface AudioProcessing {
+  // Change the config at runtime, see AudioProcessingConfig for the groups which the audio options of the sources
+  // cannot override afterwards.
+  applyConfig(config: AudioProcessingConfig): void;
+  getConfig(): AudioProcessingConfig;
+}
 
 export interface AudioProcessingFactory {
-  create(): AudioProcessing;
+  create(config?: AudioProcessingConfig): AudioProcessing;
 }
 
 declare var AudioProcessingFactory: {
@@ -1025,6 +1335,28 @@ export interface PeerConnectionFactory {
   stopAecDump(): void;
 }
 
+// extension for frame buffer pooling in OpenHarmony
+export interface FrameBufferPoolStats {
+  // requests served by a free buffer
+  readonly hits: number;
+  // requests that allocated a buffer, pooled or not
+  readonly misses: number;
+  // the most buffers held by the pool at the same time
+  readonly highWater: number;
+  // the buffers held by the pool now, and how many of them are in use
+  readonly bufferCount: number;
+  readonly inUseCount: number;
+  // the memory of the buffers held by the pool, at most 64 MiB
+  readonly byteCount: number;
+}
+
+// extension for frame buffer pooling in OpenHarmony
+export interface PeerConnectionFactory {
+  // The I420/NV12 buffers of capture, decode and scaling are recycled through a pool shared by all the factories.
+  // The free buffers are dropped when a video source is destroyed, or when their size is not requested for 10 seconds.
+  getFrameBufferPoolStats(): FrameBufferPoolStats;
+}
+
 declare var PeerConnectionFactory: {
   prototype: PeerConnectionFactory;
   new(options?: PeerConnectionFactoryOptions): PeerConnectionFactory;
@@ -1034,6 +1366,17 @@ declare var PeerConnectionFactory: {
 
 export interface Loggable {
   logMessage(message: string, severity: number, tag: string): void;
+
+  // extension for batched logging in OpenHarmony
+  // If present, it is called with all the messages queued since the last call instead of logMessage.
+  logMessages?(records: LogRecord[]): void;
+}
+
+// extension for batched logging in OpenHarmony
+export interface LogRecord {
+  message: string;
+  severity: number;
+  tag: string;
 }
 
 export class NativeLogging {
@@ -1043,4 +1386,6 @@ export class NativeLogging {
   static enableLogThreads(): void;
   static enableLogTimeStamps(): void;
   static log(message: string, severity: number, tag: string): void;
+  // Number of messages dropped since the loggable was injected, because it did not keep up with the logging.
+  static getDroppedLogCount(): number;
 }